@@ -0,0 +1,121 @@
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <vector>
+#include "Character.h"
+#include "Recipe.h"
+#include "hashMaps.h"
+#include "loading.h"
+#include "Inventory.h"
+#include "VariantClasses.h"
+
+using namespace crafting;
+
+// How often every benchmark walks over all recipes.
+constexpr int ROUNDS = 20;
+
+/**
+ * @brief Runs a benchmark and prints its time per round.
+ * @return The result of the benchmark, printed so the work can not be optimized away.
+*/
+static size_t measure(const std::string& name, const std::function<size_t()>& benchmark) {
+    size_t result = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < ROUNDS; i++) {
+        result += benchmark();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << seconds * 1000 / ROUNDS << " ms per round (result " << result << ")" << std::endl;
+    return result;
+}
+
+// The ingredient type checks as they were done before ingredients had a kind, for comparison.
+
+static bool equalsWithRtti(const Recipe& recipe, const Ingredient& other) {
+    const Recipe* otherRecipe = dynamic_cast<const Recipe*>(&other);
+    return otherRecipe != nullptr && recipe == *otherRecipe;
+}
+
+static bool equalsWithKind(const Recipe& recipe, const Ingredient& other) {
+    return recipe == other;
+}
+
+// Counts the characters of an ingredient by variant class like Inventory::hasIngredients, but with dynamic_cast.
+static void countIngredientsWithRtti(const Ingredient& ingredient, std::map<CharacterId, unsigned int>& counts) {
+    if(const Character* character = dynamic_cast<const Character*>(&ingredient)) {
+        counts[variantClasses.getRepresentative(character->getId())]++;
+    }
+    else if(const Recipe* recipe = dynamic_cast<const Recipe*>(&ingredient)) {
+        for(const Ingredient* subIngredient : recipe->getIngredients()) {
+            countIngredientsWithRtti(*subIngredient, counts);
+        }
+    }
+}
+
+static bool hasIngredientsWithRtti(const inventory::Inventory& inventory, const Ingredient& ingredient) {
+    if(const Character* character = dynamic_cast<const Character*>(&ingredient)) {
+        return inventory.hasItem(character->getId());
+    }
+    if(dynamic_cast<const Recipe*>(&ingredient) == nullptr) {
+        return false;
+    }
+    std::map<CharacterId, unsigned int> counts;
+    countIngredientsWithRtti(ingredient, counts);
+    for(const auto& count : counts) {
+        if(!inventory.hasItem(count.first, count.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    loading::loadRecipes();
+
+    std::vector<const Recipe*> recipes;
+    std::vector<const Ingredient*> ingredients;
+    for(const auto& entry : recipeMap) {
+        recipes.push_back(&entry.first);
+        for(const Ingredient* ingredient : entry.first.getIngredients()) {
+            ingredients.push_back(ingredient);
+        }
+    }
+    std::cout << recipes.size() << " recipes, " << ingredients.size() << " ingredients" << std::endl;
+
+    inventory::Inventory inventory;
+    for(const Character& character : characterTable) {
+        if(character.getRecipes().empty()) {
+            inventory.addItem(character.getId());
+        }
+    }
+
+    // every recipe is compared with an ingredient of another one, which is a mix of characters and recipes, and with itself
+    auto compare = [&](bool (*equals)(const Recipe&, const Ingredient&)) {
+        size_t matches = 0;
+        for(size_t i = 0; i < recipes.size(); i++) {
+            matches += equals(*recipes[i], *ingredients[i % ingredients.size()]);
+            matches += equals(*recipes[i], *recipes[i]);
+        }
+        return matches;
+    };
+    measure("Recipe comparison with dynamic_cast", [&]() { return compare(equalsWithRtti); });
+    measure("Recipe comparison with kind tag", [&]() { return compare(equalsWithKind); });
+
+    measure("Inventory check with dynamic_cast", [&]() {
+        size_t craftable = 0;
+        for(const Recipe* recipe : recipes) {
+            craftable += hasIngredientsWithRtti(inventory, *recipe);
+        }
+        return craftable;
+    });
+    measure("Inventory check with kind tag", [&]() {
+        size_t craftable = 0;
+        for(const Recipe* recipe : recipes) {
+            craftable += inventory.hasIngredients(*recipe);
+        }
+        return craftable;
+    });
+
+    return 0;
+}
@@ -7,9 +7,35 @@
 // Path to IDS file (containing recipes). Better not change this.
 #define IDS_PATH "resources/ids/IDS_content_only.TXT"
 
+// Whether to memory-map the IDS files instead of reading them line by line. Comment out to disable.
+#define MEMORY_MAPPED_LOADING
+
+// Number of threads used to parse memory-mapped IDS files. 1 loads serially, 0 uses one thread per hardware thread.
+#define LOADING_THREADS 0
+
 // Path to readings file (which also contains meanings). Better not change this.
 #define READINGS_PATH "resources/unihan/Unihan_Readings.txt"
 
+// Whether meanings are only read from the readings file when they are first needed, instead of all of them at start up.
+// Uncomment to enable, e.g. for servers that rarely need meanings.
+// #define LAZY_MEANINGS
+
+// Path to variants file (which links variants of the same character). Better not change this.
+#define VARIANTS_PATH "resources/unihan/Unihan_Variants.txt"
+
+// Path to dictionary like data file (which contains the input codes and frequencies of the characters among others). Better not change this.
+#define DICTIONARY_LIKE_DATA_PATH "resources/unihan/Unihan_DictionaryLikeData.txt"
+
+// Path to radical stroke counts file (which contains the radical and strokes of the characters). Better not change this.
+#define RADICAL_STROKE_COUNTS_PATH "resources/unihan/Unihan_RadicalStrokeCounts.txt"
+
+// Whether variants of a character, like 亻 and 人 or 门 and 門, count as the same character when crafting. Comment out to disable.
+#define VARIANT_EQUIVALENCE
+
+// Path to the binary database image, which is rebuilt automatically when the source files or the settings below change.
+// Comment out to always load from the source files.
+#define DATABASE_IMAGE_PATH "resources/database.bin"
+
 /*  ~~~~ Preferred country specific variant for recipes ~~~~
             G = China
             H = Hong Kong SAR
@@ -22,6 +48,7 @@
             U = Unicode
             B = UK
             V = Vietnam
+    The recipes of all variants are loaded, this is only the one used at start up. See player::Player::setRegion.
 */
 #define PREFERRED_CHARACTER_VARIANT 'U'
 
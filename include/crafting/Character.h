@@ -2,23 +2,23 @@
 #define CHARACTER_H
 
 #include "Ingredient.h"
+#include "CharacterId.h"
 #include "Recipe.h"
+#include "Region.h"
 #include "Functionality.h"
 #include "byteUtil.h"
+#include <memory>
+#include <string_view>
 #include <vector>
 
 namespace crafting {
 
 /**
- * @brief A Chinese character that can be obtained as an item by the player or referenced in a recipe.
+ * @brief The data of a character that is needed while crafting and rendering, kept together in one compact array.
+ * See CharacterTable.
 */
-class Character : public Ingredient {
-private:
-    char32_t mCharacter;
-    std::vector<std::string> meanings;
-    std::vector<Recipe> recipes;
-    std::vector<char32_t> alternatives;
-    std::vector<std::unique_ptr<items::Functionality>> functionalities;
+struct CharacterData {
+    char32_t codePoint;
     /**
      * Bit 0: Can be placed like ⿸
      * Bit 1: Can be placed like ⿹
@@ -28,20 +28,44 @@ private:
      * Bit 5: Can be placed like ⿶
      * Bit 6: Can be placed like ⿷
     */
-    uint8_t placementFlags = 0;
+    uint8_t placementFlags;
     /**
      * Bit 0: Free space in lower right
      * Bit 1: Free space in lower left
      * Bit 2: Free space in upper right
     */
-    uint8_t glyphFlags = 0;
+    uint8_t glyphFlags;
+    // The font face the character is rendered with, see Character::render.
+    uint8_t fontFace;
+};
+
+/**
+ * @brief A Chinese character that can be obtained as an item by the player or referenced in a recipe.
+*/
+class Character : public Ingredient {
+private:
+    // The character's data lives in the character table, see CharacterTable.
+    CharacterId mId;
+    /**
+     * @brief Gets the frequently used data of the character.
+    */
+    CharacterData& data() const;
+    /**
+     * @brief Gets the font face the character is rendered with, looking it up the first time.
+    */
+    uint8_t lookUpFontFace() const;
 public:
     /**
      * @brief Constructs an empty Character object.
     */
-    Character() : mCharacter(0) {}
+    Character() : Ingredient(IngredientKind::CHARACTER), mId(CharacterId::NONE) {}
     /**
-     * @brief Constructs a new Character object.
+     * @brief Constructs a Character object for a character in the character table.
+     * @param id The id of the character to represent.
+    */
+    explicit Character(CharacterId id) : Ingredient(IngredientKind::CHARACTER), mId(id) {}
+    /**
+     * @brief Constructs a new Character object, adding the character to the character table if needed.
      * @param character The character to represent.
     */
     Character(char32_t character);
@@ -49,30 +73,62 @@ public:
     bool operator==(const Character& other) const;
     operator std::u32string() const;
 
-    rendering::GreyBitmap render(int width, int height) const override;
+    rendering::GreyBitmap render(int width, int height, Region region) const override;
+    /**
+     * @brief Whether the character is in one of the font faces. Otherwise it is rendered from its first recipe in the region.
+     * Must not be called from several threads at once, since FreeType font faces are not thread-safe.
+    */
+    bool isInFontFaces() const;
 
-    std::shared_ptr<Ingredient> addLeft(std::shared_ptr<Character> character) override;
-    std::shared_ptr<Ingredient> addRight(std::shared_ptr<Character> character) override;	
-    std::shared_ptr<Ingredient> addAbove(std::shared_ptr<Character> character) override;		
-    std::shared_ptr<Ingredient> addBelow(std::shared_ptr<Character> character) override;
+    const Ingredient* addLeft(CharacterId character) const override;
+    const Ingredient* addRight(CharacterId character) const override;	
+    const Ingredient* addAbove(CharacterId character) const override;		
+    const Ingredient* addBelow(CharacterId character) const override;
 
-    operator char32_t() const { return mCharacter; }
+    operator char32_t() const { return getCharacter(); }
+    /**
+     * @brief Gets the id of the character in the character table.
+    */
+    CharacterId getId() const { return mId; }
     /**
      * @brief Gets the character represented by this object.
     */
-    char32_t getCharacter() const { return mCharacter; }
+    char32_t getCharacter() const;
+    /**
+     * @brief Gets a vector of the meanings of the character represented by this object, as views into the meaning pool.
+     * Loads them first if they are loaded lazily, see LazyMeanings. Safe to call from several threads at once,
+     * as long as no meanings are added in other ways at the same time.
+    */
+    std::vector<std::string_view> getMeanings() const;
+    /**
+     * @brief Gets a vector of the recipes that can be used to obtain the character represented by this object, in all regions.
+    */
+    const std::vector<Recipe>& getRecipes() const;
     /**
-     * @brief Gets a vector of the meanings of the character represented by this object.
+     * @brief Gets the regions the recipe with the given index in getRecipes is used in.
     */
-    const std::vector<std::string>& getMeanings() const { return meanings; }
+    RegionMask getRecipeRegions(size_t index) const;
     /**
-     * @brief Gets a vector of the recipes that can be used to obtain the character represented by this object.
+     * @brief Whether the recipe with the given index in getRecipes is used in the given region.
     */
-    const std::vector<Recipe>& getRecipes() const { return recipes; }
+    bool isRecipeActive(size_t index, Region region) const { return isActiveIn(getRecipeRegions(index), region); }
+    /**
+     * @brief Whether the given recipe makes the character represented by this object in the given region.
+    */
+    bool isRecipeActive(const Recipe& recipe, Region region) const;
+    /**
+     * @brief Gets the first recipe of the character that is used in the given region.
+     * @return The recipe, or nullptr if the character has none.
+    */
+    const Recipe* getActiveRecipe(Region region) const;
     /**
      * @brief Gets a vector of characters that are considered equivalent to the character represented by this object.
     */
-    const std::vector<char32_t>& getAlternatives() const { return alternatives; }
+    const std::vector<char32_t>& getAlternatives() const;
+    /**
+     * @brief Adds a character that is considered equivalent to the character represented by this object.
+    */
+    void addAlternative(char32_t alternative);
     /**
      * @brief Whether the character can be placed like the given Ideographic Description Character in a recipe.
      * @param character The Ideographic Description Character to compare with; one of ⿸, ⿹, ⿺ ⿴, ⿵, ⿶, or ⿷.
@@ -84,39 +140,58 @@ public:
      * @param value The value to set the flag to.
     */
     void setPlacementFlag(char32_t character, bool value);
+    /**
+     * @brief Gets all placement flags as one byte, see canBePlacedLike for the meaning of each bit.
+    */
+    uint8_t getPlacementFlags() const { return data().placementFlags; }
+    /**
+     * @brief Sets all placement flags at once, see canBePlacedLike for the meaning of each bit.
+    */
+    void setPlacementFlags(uint8_t flags) { data().placementFlags = flags; }
+    /**
+     * @brief Gets all glyph flags as one byte.
+    */
+    uint8_t getGlyphFlags() const { return data().glyphFlags; }
+    /**
+     * @brief Sets all glyph flags at once.
+    */
+    void setGlyphFlags(uint8_t flags) { data().glyphFlags = flags; }
     /**
      * @brief Gets whether the character has free space in the lower right corner.
     */
-    bool getFreeSpaceInLowerRight() { return glyphFlags & 1; }
+    bool getFreeSpaceInLowerRight() { return data().glyphFlags & 1; }
     /**
      * @brief Sets whether the character has free space in the lower right corner.
     */
-    void setFreeSpaceInLowerRight(bool freeSpace) { util::setBit(&glyphFlags, 0, freeSpace); }
+    void setFreeSpaceInLowerRight(bool freeSpace) { util::setBit(&data().glyphFlags, 0, freeSpace); }
     /**
      * @brief Gets whether the character has free space in the lower left corner.
     */
-    bool getFreeSpaceInLowerLeft() { return glyphFlags & 2; }
+    bool getFreeSpaceInLowerLeft() { return data().glyphFlags & 2; }
     /**
      * @brief Sets whether the character has free space in the lower left corner.
     */
-    void setFreeSpaceInLowerLeft(bool freeSpace) { util::setBit(&glyphFlags, 1, freeSpace); }
+    void setFreeSpaceInLowerLeft(bool freeSpace) { util::setBit(&data().glyphFlags, 1, freeSpace); }
     /**
      * @brief Gets whether the character has free space in the upper right corner.
     */
-    bool getFreeSpaceInUpperRight() { return glyphFlags & 4; }
+    bool getFreeSpaceInUpperRight() { return data().glyphFlags & 4; }
     /**
      * @brief Sets whether the character has free space in the upper right corner.
     */
-    void setFreeSpaceInUpperRight(bool freeSpace) { util::setBit(&glyphFlags, 2, freeSpace); }
+    void setFreeSpaceInUpperRight(bool freeSpace) { util::setBit(&data().glyphFlags, 2, freeSpace); }
     /**
-     * @brief Adds a meaning to the character represented by this object.
+     * @brief Adds a meaning to the character represented by this object. The meaning is copied into the meaning pool,
+     * unless an equal one is in it already.
     */
-    void addMeaning(std::string meaning) { meanings.push_back(meaning); }
+    void addMeaning(std::string_view meaning);
     /**
      * @brief Adds a recipe to the character represented by this object.
+     * If the character already has an equal recipe, the regions are added to it instead.
      * @param recipe The recipe to add.
+     * @param regions The regions the recipe is used in.
     */
-    void addRecipe(Recipe& recipe) { recipes.push_back(recipe); }
+    void addRecipe(const Recipe& recipe, RegionMask regions = ALL_REGIONS);
     /**
      * @brief Adds a recipe to the character represented by this object.
      * @param recipeString The string representation of the recipe to add.
@@ -126,14 +201,12 @@ public:
     /**
      * @brief Adds a functionality to the character represented by this object.
     */
-    void addFunctionality(std::unique_ptr<items::Functionality> functionality) {
-        functionalities.push_back(std::move(functionality));
-    }
+    void addFunctionality(std::unique_ptr<items::Functionality> functionality);
 
     /**
      * @brief Gets a vector of the functionalities of the character represented by this object.
     */
-    const std::vector<std::unique_ptr<items::Functionality>>& getFunctionalities() const { return functionalities; }
+    const std::vector<std::unique_ptr<items::Functionality>>& getFunctionalities() const;
 };
 
 } // namespace crafting
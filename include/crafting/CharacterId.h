@@ -0,0 +1,18 @@
+#ifndef CHARACTER_ID_H
+#define CHARACTER_ID_H
+
+#include <cstdint>
+
+namespace crafting {
+
+/**
+ * @brief Handle of a character in the character table. Ids are handed out in the order characters are first seen,
+ * 0 means no character.
+*/
+enum class CharacterId : uint32_t {
+    NONE = 0
+};
+
+} // namespace crafting
+
+#endif // ifndef CHARACTER_ID_H
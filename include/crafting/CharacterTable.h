@@ -0,0 +1,101 @@
+#ifndef CHARACTER_TABLE_H
+#define CHARACTER_TABLE_H
+
+#include "Character.h"
+#include "CharacterId.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief The data of a character that is rarely needed. Only allocated for characters that have any of it.
+*/
+struct CharacterDetails {
+    // Ids of the meanings in meaningPool, see hashMaps.h.
+    std::vector<uint32_t> meanings;
+    std::vector<Recipe> recipes;
+    // The regions each recipe is used in, in the same order as the recipes.
+    std::vector<RegionMask> recipeRegions;
+    std::vector<char32_t> alternatives;
+    std::vector<std::unique_ptr<items::Functionality>> functionalities;
+};
+
+/**
+ * @brief Stores all characters, indexed by id and by code point.
+ *
+ * The CJK blocks are looked up directly in arrays covering them, all other code points (e.g. the Private Use Area)
+ * through a two-level table of pages that are only allocated when a character in them is added.
+ * Character objects are only flyweights holding their id, the actual data is split into hot and cold arrays.
+*/
+class CharacterTable {
+private:
+    // Code points from the CJK Radicals Supplement up to the end of the CJK Unified Ideographs.
+    static constexpr char32_t BMP_CJK_BEGIN = 0x2E80;
+    static constexpr char32_t BMP_CJK_END = 0xA000;
+    // The CJK Unified Ideographs Extensions B to H.
+    static constexpr char32_t SIP_CJK_BEGIN = 0x20000;
+    static constexpr char32_t SIP_CJK_END = 0x32400;
+    static constexpr int PAGE_BITS = 8;
+    static constexpr char32_t PAGE_SIZE = 1 << PAGE_BITS;
+    static constexpr char32_t MAX_CODE_POINT = 0x110000;
+
+    std::vector<uint32_t> bmpCjkIds;
+    std::vector<uint32_t> sipCjkIds;
+    std::vector<std::unique_ptr<uint32_t[]>> pages;
+
+    std::vector<CharacterData> hot;
+    std::vector<std::unique_ptr<CharacterDetails>> cold;
+    // A deque, so the addresses of the characters stay valid when more are added.
+    std::deque<Character> characters;
+
+    /**
+     * @brief Gets the slot holding the id of the given code point, or nullptr if there is none yet.
+     * @param create Whether to allocate the slot if it does not exist.
+    */
+    uint32_t* slot(char32_t codePoint, bool create);
+public:
+    CharacterTable();
+    CharacterTable(const CharacterTable&) = delete;
+    CharacterTable& operator=(const CharacterTable&) = delete;
+
+    /**
+     * @brief Gets the id of the given code point, adding a new character if it is not in the table yet.
+    */
+    CharacterId getId(char32_t codePoint);
+    /**
+     * @brief Gets the id of the given code point without adding it.
+     * @return The id, or CharacterId::NONE if the code point is not in the table.
+    */
+    CharacterId find(char32_t codePoint) const;
+
+    Character& operator[](CharacterId id) { return characters[uint32_t(id)]; }
+    const Character& operator[](CharacterId id) const { return characters[uint32_t(id)]; }
+    CharacterData& data(CharacterId id) { return hot[uint32_t(id)]; }
+    const CharacterData& data(CharacterId id) const { return hot[uint32_t(id)]; }
+    /**
+     * @brief Gets the rarely used data of the given character, allocating it if the character has none yet.
+    */
+    CharacterDetails& details(CharacterId id);
+    /**
+     * @brief Gets the rarely used data of the given character.
+     * @return The data, or nullptr if the character has none.
+    */
+    const CharacterDetails* findDetails(CharacterId id) const { return cold[uint32_t(id)].get(); }
+
+    /**
+     * @brief Gets the number of characters in the table.
+    */
+    size_t size() const { return characters.size() - 1; }
+    // Iterates over all characters in the order of their ids.
+    std::deque<Character>::iterator begin() { return std::next(characters.begin()); }
+    std::deque<Character>::iterator end() { return characters.end(); }
+    std::deque<Character>::const_iterator begin() const { return std::next(characters.begin()); }
+    std::deque<Character>::const_iterator end() const { return characters.end(); }
+};
+
+} // namespace crafting
+
+#endif // ifndef CHARACTER_TABLE_H
@@ -0,0 +1,92 @@
+#ifndef COMPONENT_INDEX_H
+#define COMPONENT_INDEX_H
+
+#include "CharacterId.h"
+#include "Recipe.h"
+#include "Region.h"
+#include "ArrayView.h"
+#include "PostingLists.h"
+#include <cstdint>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A reverse index from every character to the recipes of the recipe map it is used in, and to the characters
+ * those recipes make. Answers questions like "what can I make with 木?" without scanning the recipe map.
+ *
+ * A character is used directly in a recipe if it is one of the recipe's own ingredients, e.g. 木 in ⿱木林,
+ * and transitively if it appears anywhere in the recipe's tree, e.g. 木 in ⿱木⿰木木 or 口 in ⿰口⿱口口.
+*/
+class ComponentIndex {
+private:
+    // The recipes of the recipe map, sorted by id.
+    std::vector<const Recipe*> recipes;
+    // The results of each recipe, owned by the recipe map.
+    std::vector<const std::vector<CharacterId>*> recipeResults;
+    // The regions each recipe makes each of its results in, in the same order as the results.
+    util::PostingLists<RegionMask> resultRegions;
+    // Indices into recipes for every character id.
+    util::PostingLists<uint32_t> directRecipes;
+    util::PostingLists<uint32_t> allRecipes;
+    // Result characters for every character id, without duplicates.
+    util::PostingLists<CharacterId> directResults;
+    util::PostingLists<CharacterId> allResults;
+
+    /**
+     * @brief Fills the result lists from the recipe lists.
+    */
+    void buildResults(const util::PostingLists<uint32_t>& componentRecipes, util::PostingLists<CharacterId>& componentResults);
+public:
+    /**
+     * @brief Builds the index from the recipe map. Has to be called again if recipes are registered afterwards.
+    */
+    void build();
+
+    /**
+     * @brief Gets the recipes the given character is used in, in all regions.
+     * @param component The character to look up.
+     * @param transitive Whether to include recipes that only use the character in one of their sub-recipes.
+     * @return Indices of the recipes, see getRecipe and getResults.
+    */
+    util::ArrayView<uint32_t> getRecipesUsing(CharacterId component, bool transitive = true) const {
+        return transitive ? allRecipes[uint32_t(component)] : directRecipes[uint32_t(component)];
+    }
+    /**
+     * @brief Gets the characters that are made by recipes the given character is used in, in all regions, ordered by id.
+     * @param component The character to look up.
+     * @param transitive Whether to include recipes that only use the character in one of their sub-recipes.
+    */
+    util::ArrayView<CharacterId> getResultsUsing(CharacterId component, bool transitive = true) const {
+        return transitive ? allResults[uint32_t(component)] : directResults[uint32_t(component)];
+    }
+    /**
+     * @brief Gets a recipe by the index returned from getRecipesUsing.
+    */
+    const Recipe& getRecipe(uint32_t index) const { return *recipes[index]; }
+    /**
+     * @brief Gets the characters made by a recipe, by the index returned from getRecipesUsing.
+    */
+    const std::vector<CharacterId>& getResults(uint32_t index) const { return *recipeResults[index]; }
+    /**
+     * @brief Gets the regions a recipe makes each of its results in, in the same order as getResults.
+    */
+    util::ArrayView<RegionMask> getResultRegions(uint32_t index) const { return resultRegions[index]; }
+    /**
+     * @brief Whether a recipe makes the given result in the given region.
+     * The index holds the recipes of all regions, so that players of different regions can share it.
+     * @param index The index of the recipe, as returned from getRecipesUsing.
+    */
+    bool isActive(uint32_t index, CharacterId result, Region region) const;
+    /**
+     * @brief Gets the number of recipes in the index.
+    */
+    size_t size() const { return recipes.size(); }
+};
+
+// The index of the loaded recipes, built by loading::loadAll.
+extern ComponentIndex componentIndex;
+
+} // namespace crafting
+
+#endif // ifndef COMPONENT_INDEX_H
@@ -0,0 +1,86 @@
+#ifndef CRAFTABILITY_SOLVER_H
+#define CRAFTABILITY_SOLVER_H
+
+#include "CharacterId.h"
+#include "Region.h"
+#include "Inventory.h"
+#include "PostingLists.h"
+#include "Bitset.h"
+#include <cstdint>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A character a recipe needs, and how often. Any variant of the character will do,
+ * so it is the representative of its variant class, see VariantClasses.
+*/
+struct Requirement {
+    CharacterId character;
+    uint32_t count;
+};
+
+/**
+ * @brief Finds the characters that can be crafted from an inventory, either right away or through chains of crafts
+ * where crafted characters are used in later recipes. Works on the recipes of the component index.
+*/
+class CraftabilitySolver {
+private:
+    // The characters each recipe consumes when crafted, see Inventory::removeIngredients. Indexed like the component index.
+    util::PostingLists<Requirement> requirements;
+    // The recipes that make each character, by character id.
+    util::PostingLists<uint32_t> producers;
+    // The recipes requiring each variant class, by the id of its representative.
+    util::PostingLists<uint32_t> consumers;
+
+    class Verifier;
+    /**
+     * @brief Finds every character that can be reached from the inventory when quantities are ignored,
+     * by propagating newly reachable characters through the recipes that use them until nothing changes.
+     * @param classes Set to the variant classes of the reachable characters, by representative.
+    */
+    util::Bitset findReachableIgnoringQuantities(const inventory::Inventory& inventory, Region region, util::Bitset& classes) const;
+public:
+    /**
+     * @brief Builds the solver from the component index and the variant classes. Has to be called again if either is rebuilt.
+    */
+    void build();
+
+    /**
+     * @brief Gets the characters a recipe consumes when crafted.
+     * @param recipe The index of the recipe in the component index.
+    */
+    util::ArrayView<Requirement> getRequirements(uint32_t recipe) const { return requirements[recipe]; }
+    /**
+     * @brief Gets the recipes that make the given character, as indices into the component index.
+    */
+    util::ArrayView<uint32_t> getProducers(CharacterId character) const { return producers[uint32_t(character)]; }
+    /**
+     * @brief Gets the recipes requiring the given character or one of its variants, as indices into the component index.
+    */
+    util::ArrayView<uint32_t> getConsumers(CharacterId character) const;
+
+    /**
+     * @brief Finds all characters that can be crafted with a single craft from the items in the inventory.
+     * @param region The region whose recipes are used.
+     * @return The characters, ordered by id.
+    */
+    std::vector<CharacterId> findCraftable(const inventory::Inventory& inventory, Region region) const;
+
+    /**
+     * @brief Finds all characters that are not in the inventory but can be obtained from it through one or more crafts,
+     * where crafted characters can be used as ingredients of later crafts. Every item of the inventory can only be used once.
+     * Candidates are found by a fixpoint over the recipe graph first and then checked against the item amounts in parallel.
+     * @param region The region whose recipes are used.
+     * @param threads The number of threads to check candidates on, or 0 to use one per hardware thread.
+     * @return The characters, ordered by id.
+    */
+    std::vector<CharacterId> findReachable(const inventory::Inventory& inventory, Region region, unsigned int threads = 0) const;
+};
+
+// The solver for the loaded recipes, built by loading::loadAll.
+extern CraftabilitySolver craftabilitySolver;
+
+} // namespace crafting
+
+#endif // ifndef CRAFTABILITY_SOLVER_H
@@ -0,0 +1,130 @@
+#ifndef CRAFTING_PLANNER_H
+#define CRAFTING_PLANNER_H
+
+#include "CharacterId.h"
+#include "Recipe.h"
+#include "Region.h"
+#include "Inventory.h"
+#include "Bitset.h"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A single craft of a plan, to be done with Player::craft(*recipe, variation).
+*/
+struct CraftStep {
+    const Recipe* recipe;
+    // The index of the result in the recipe's results, see Player::craft.
+    unsigned int variation;
+    CharacterId result;
+};
+
+/**
+ * @brief What crafting costs, the planner minimizes the sum of these.
+*/
+struct CraftCosts {
+    // The cost of every item taken from the inventory, at least 1.
+    uint32_t perItem = 1;
+    // The additional cost of every craft, e.g. the ink it uses.
+    uint32_t perCraft = 0;
+};
+
+/**
+ * @brief Plans the cheapest chain of crafts that makes a character from the items of an inventory.
+ *
+ * The planner keeps the minimum cost of obtaining every character from the characters in the inventory, where owned
+ * characters and their variants cost one item and any other character costs the cheapest of the recipes that make it,
+ * over all of its alternative recipes. Like Player::craft, recipes take any variant of the characters they need. The costs are found with Dijkstra's algorithm over the recipes of the component index, a recipe
+ * becoming usable once all characters it needs have a cost. When the inventory changes, only the costs depending on
+ * characters that were gained or lost are recomputed, so they can be reused across queries and inventory changes.
+ * Recipes with unordered operators like ⿻ are a single recipe in the recipe map, so they are planned like any other.
+ *
+ * The costs do not consider item amounts, plans are checked against them when they are made.
+*/
+class CraftingPlanner {
+private:
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+    static constexpr uint32_t NO_RECIPE = UINT32_MAX;
+
+    CraftCosts costs;
+    // The region the costs were computed for, whose recipes are used.
+    Region region = Region::COUNT;
+    // The variant classes that had items in the inventory at the last update, by representative, as a set and as a sorted list.
+    util::Bitset owned;
+    std::vector<CharacterId> ownedList;
+    // The minimum cost of obtaining one of each character, by id.
+    std::vector<uint32_t> cost;
+    // The minimum cost of crafting each character instead of taking it from the inventory, and the recipe to do so.
+    std::vector<uint32_t> craftCost;
+    std::vector<uint32_t> craftRecipe;
+    // Characters whose cost was lowered and has to be passed on to the recipes using them, cheapest first.
+    std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>, std::greater<>> queue;
+
+    /**
+     * @brief Gets the minimum cost of obtaining one of any character of a variant class.
+    */
+    uint32_t classCost(CharacterId representative) const;
+    /**
+     * @brief Gets the cost of crafting a recipe with the current costs of its requirements.
+    */
+    uint32_t recipeCost(uint32_t recipe) const;
+    /**
+     * @brief Offers a recipe as a way of crafting the character and updates its costs if it is cheaper.
+    */
+    void offer(uint32_t character, uint32_t recipe, uint32_t recipeCost);
+    /**
+     * @brief Passes lowered costs on until no cost changes anymore.
+    */
+    void propagate();
+    /**
+     * @brief Resets the costs of all characters that depended on the lost variant classes and recomputes them from their recipes.
+    */
+    void raise(const std::vector<CharacterId>& lost);
+    /**
+     * @brief Adds the crafts needed to obtain one of the character to the plan.
+     * @param fromInventory Whether any variant of the character will do, taken from the inventory where possible.
+     * @param taken How many of each variant class the plan already takes from the inventory, by representative.
+     * @return True if the character can be obtained, false otherwise.
+    */
+    bool expand(CharacterId character, const inventory::Inventory& inventory, bool fromInventory, int depth,
+        std::unordered_map<uint32_t, unsigned int>& taken, std::vector<CraftStep>& steps) const;
+public:
+    /**
+     * @brief Constructs a planner with the given costs. The costs are computed when it is first updated.
+    */
+    CraftingPlanner(CraftCosts costs = {});
+
+    /**
+     * @brief Updates the costs to the characters in the inventory. Cheap if the inventory changed little since the last update.
+     * Everything is recomputed if the component index was rebuilt or the region differs from the last update.
+     * @param region The region whose recipes are used.
+    */
+    void update(const inventory::Inventory& inventory, Region region);
+
+    /**
+     * @brief Gets the minimum cost of obtaining one of the character as of the last update.
+     * @return The cost, or UINT32_MAX if the character can not be obtained.
+    */
+    uint32_t getCost(CharacterId character) const;
+
+    /**
+     * @brief Plans the cheapest way of crafting the target from the items in the inventory, updating the costs first.
+     * The target is crafted even if it already is in the inventory.
+     * @param inventory The inventory to craft from.
+     * @param region The region whose recipes are used.
+     * @param target The character to craft.
+     * @param steps Set to the crafts to do, in order.
+     * @return True if a plan was found, false if the target can not be crafted from the inventory.
+    */
+    bool plan(const inventory::Inventory& inventory, Region region, CharacterId target, std::vector<CraftStep>& steps);
+};
+
+} // namespace crafting
+
+#endif // ifndef CRAFTING_PLANNER_H
@@ -0,0 +1,112 @@
+#ifndef DECOMPOSITION_TABLE_H
+#define DECOMPOSITION_TABLE_H
+
+#include "CharacterId.h"
+#include "Region.h"
+#include "ArrayView.h"
+#include "Bitset.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A primitive character in a decomposition, and how often it is used.
+*/
+struct PrimitiveCount {
+    CharacterId character;
+    uint32_t count;
+};
+
+/**
+ * @brief The full decomposition of every character into primitive characters, the characters without recipes.
+ * A character is decomposed along its first recipe, the one it is rendered with, and the decompositions of the characters
+ * in that recipe, e.g. 森 into three 木. Primitives decompose into themselves. The recipes are those of the region
+ * the table is built for.
+ *
+ * Some IDS entries refer back to the character, directly or through other characters. Such a character is kept
+ * as a primitive where it closes the cycle, and the decompositions containing it are marked as cyclic.
+*/
+class DecompositionTable {
+private:
+    struct Range {
+        uint32_t first;
+        uint32_t size;
+    };
+    // The decompositions of all characters, each sorted by id.
+    std::vector<PrimitiveCount> primitives;
+    // The part of primitives belonging to each character, by id.
+    std::vector<Range> ranges;
+    // The total number of primitives of each character, by id.
+    std::vector<uint32_t> totals;
+    util::Bitset cyclic;
+    Region region = getDefaultRegion();
+
+    /**
+     * @brief Decomposes the character after decomposing the characters of its recipe.
+     * @param state 0 for characters that have not been visited, 1 while they are being decomposed, 2 once they are done.
+    */
+    void decompose(uint32_t character, std::vector<uint8_t>& state);
+public:
+    /**
+     * @brief Builds the decompositions of all characters in the character table. Has to be called again if recipes are added.
+     * @param region The region whose recipes the characters are decomposed along.
+    */
+    void build(Region region);
+    /**
+     * @brief Gets the region the table was built for.
+    */
+    Region getRegion() const { return region; }
+
+    /**
+     * @brief Gets the primitives the character consists of, ordered by id.
+    */
+    util::ArrayView<PrimitiveCount> getPrimitives(CharacterId character) const {
+        const Range& range = ranges[uint32_t(character)];
+        return {primitives.data() + range.first, range.size};
+    }
+    /**
+     * @brief Gets the number of primitives needed for the character, counting repeated ones every time.
+    */
+    uint32_t getTotalPrimitives(CharacterId character) const { return totals[uint32_t(character)]; }
+    /**
+     * @brief Checks whether the character has no recipes.
+    */
+    bool isPrimitive(CharacterId character) const {
+        const Range& range = ranges[uint32_t(character)];
+        return range.size == 1 && primitives[range.first].character == character && !cyclic.test(uint32_t(character));
+    }
+    /**
+     * @brief Checks whether the decomposition of the character ran into a self-referential recipe.
+    */
+    bool isCyclic(CharacterId character) const { return cyclic.test(uint32_t(character)); }
+};
+
+/**
+ * @brief The decomposition tables of all regions. Most players share a region, so a table is only built the first time
+ * it is needed. Can be used from several threads at once.
+*/
+class DecompositionTables {
+private:
+    std::mutex mutex;
+    std::unique_ptr<DecompositionTable> tables[size_t(Region::COUNT)];
+public:
+    /**
+     * @brief Gets the table of the given region, building it if it has not been built yet.
+    */
+    const DecompositionTable& get(Region region);
+    /**
+     * @brief Drops the tables of all regions, so they are built again from the current recipes when they are needed.
+     * Has to be called if recipes are added. Tables gotten before must not be used anymore.
+    */
+    void clear();
+};
+
+// The decompositions of the loaded characters by region. The one of the default region is built by loading::loadAll.
+extern DecompositionTables decompositionTables;
+
+} // namespace crafting
+
+#endif // ifndef DECOMPOSITION_TABLE_H
@@ -0,0 +1,130 @@
+#ifndef DICTIONARY_DATA_H
+#define DICTIONARY_DATA_H
+
+#include "CharacterId.h"
+#include "ArrayView.h"
+#include "PostingLists.h"
+#include "Region.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief The fields of the unihan dictionary like data file that can be loaded into DictionaryData.
+*/
+enum class DictionaryField : uint8_t {
+    CANGJIE,           // kCangjie, the Cangjie input code, e.g. D for 木
+    FOUR_CORNER_CODE,  // kFourCornerCode, the Four-Corner codes, e.g. 4090.0 for 木
+    FREQUENCY,         // kFrequency, from 1 for the most frequent characters to 5
+    GRADE_LEVEL,       // kGradeLevel, the school grade the character is taught in in Hong Kong, from 1 to 6
+    UNIHAN_CORE_2020,  // kUnihanCore2020, the regions whose core set contains the character
+    COUNT
+};
+
+// A set of dictionary fields, one bit per DictionaryField.
+using DictionaryFieldMask = uint32_t;
+
+constexpr DictionaryFieldMask ALL_DICTIONARY_FIELDS = (1 << int(DictionaryField::COUNT)) - 1;
+
+constexpr DictionaryFieldMask fieldBit(DictionaryField field) {
+    return DictionaryFieldMask(1 << int(field));
+}
+
+// Input codes are packed into integers with a fixed number of bits per symbol, starting from the highest bits,
+// and 0 after the last symbol. So packed codes sort like the codes themselves and the codes with a prefix form a range.
+// Packs a Cangjie code of up to 5 letters from A to Z, 5 bits each. Returns 0 if the code is invalid.
+uint32_t packCangjie(std::string_view code);
+std::string unpackCangjie(uint32_t packed);
+// Gets the range [first, last) of the packed Cangjie codes starting with a prefix, e.g. "dd". Empty if the prefix is invalid.
+std::pair<uint32_t, uint32_t> cangjiePrefixRange(std::string_view prefix);
+// Packs a Four-Corner code like 4090.0 or 4090, as 5 digits of 4 bits. Returns 0 if the code is invalid.
+uint32_t packFourCornerCode(std::string_view code);
+std::string unpackFourCornerCode(uint32_t packed);
+// Gets the range [first, last) of the packed Four-Corner codes starting with a prefix, e.g. "409" or "4090.". Empty if the prefix is invalid.
+std::pair<uint32_t, uint32_t> fourCornerPrefixRange(std::string_view prefix);
+
+/**
+ * @brief Fields of the unihan dictionary like data in one array per field, indexed by character id.
+ * Small numbers are stored as bytes and input codes packed into integers, so the text of the file is not kept.
+*/
+class DictionaryData {
+private:
+    DictionaryFieldMask loadedFields = 0;
+    std::vector<uint32_t> cangjie;
+    std::vector<uint8_t> frequencies;
+    std::vector<uint8_t> gradeLevels;
+    std::vector<RegionMask> coreRegions;
+    // Characters can have several Four-Corner codes. They are collected while loading and stored by character in build.
+    std::vector<std::pair<CharacterId, uint32_t>> pendingFourCornerCodes;
+    util::PostingLists<uint32_t> fourCornerCodes;
+public:
+    /**
+     * @brief Clears all fields and starts loading the given ones.
+    */
+    void reset(DictionaryFieldMask fields);
+    /**
+     * @brief Sets a field of a character from its value in the unihan file. Fields that are not being loaded are ignored.
+     * @param value The value as in the file, e.g. "4090.0 4091.0" for kFourCornerCode.
+     * @return True if the value was stored, false if the field is not being loaded or the value is invalid.
+    */
+    bool add(CharacterId character, DictionaryField field, std::string_view value);
+    /**
+     * @brief Sets a field of a character from its packed value, as returned by the getters, e.g. from a database image.
+     * Four-Corner codes are added one at a time.
+     * @return True if the value was stored, false if the field is not being loaded or the value is 0.
+    */
+    bool addPacked(CharacterId character, DictionaryField field, uint32_t value);
+    /**
+     * @brief Finishes loading, has to be called after all values were added.
+    */
+    void build();
+
+    /**
+     * @brief Whether the given field was loaded.
+    */
+    bool isLoaded(DictionaryField field) const { return loadedFields & fieldBit(field); }
+    /**
+     * @brief Gets the fields that were loaded.
+    */
+    DictionaryFieldMask getLoadedFields() const { return loadedFields; }
+
+    /**
+     * @brief Gets the packed Cangjie code of a character, see unpackCangjie, or 0 if it has none.
+    */
+    uint32_t getCangjie(CharacterId character) const {
+        return uint32_t(character) < cangjie.size() ? cangjie[uint32_t(character)] : 0;
+    }
+    /**
+     * @brief Gets the packed Four-Corner codes of a character, see unpackFourCornerCode.
+    */
+    util::ArrayView<uint32_t> getFourCornerCodes(CharacterId character) const { return fourCornerCodes[uint32_t(character)]; }
+    /**
+     * @brief Gets how frequently a character is used, from 1 for the most frequent to 5, or 0 if unknown.
+    */
+    uint8_t getFrequency(CharacterId character) const {
+        return uint32_t(character) < frequencies.size() ? frequencies[uint32_t(character)] : 0;
+    }
+    /**
+     * @brief Gets the grade a character is taught in, from 1 to 6, or 0 if unknown.
+    */
+    uint8_t getGradeLevel(CharacterId character) const {
+        return uint32_t(character) < gradeLevels.size() ? gradeLevels[uint32_t(character)] : 0;
+    }
+    /**
+     * @brief Gets the regions whose core set contains the character, see Region.h.
+    */
+    RegionMask getCoreRegions(CharacterId character) const {
+        return uint32_t(character) < coreRegions.size() ? coreRegions[uint32_t(character)] : 0;
+    }
+};
+
+// The dictionary data of the loaded characters, loaded by loading::loadDictionaryData.
+extern DictionaryData dictionaryData;
+
+} // namespace crafting
+
+#endif // ifndef DICTIONARY_DATA_H
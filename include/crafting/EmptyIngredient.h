@@ -3,19 +3,19 @@
 #define EMPTY_INGREDIENT_H
 
 #include "Ingredient.h"
-#include <memory>
 
 namespace crafting {
 
 class EmptyIngredient : public Ingredient {
 public:
+    EmptyIngredient() : Ingredient(IngredientKind::EMPTY) {}
     bool operator==(const Ingredient& other) const override;
     operator std::u32string() const override;
-    rendering::GreyBitmap render(int width, int height) const override;
-    std::shared_ptr<Ingredient> addLeft(std::shared_ptr<Character> character) override;
-    std::shared_ptr<Ingredient> addRight(std::shared_ptr<Character> character) override;	
-    std::shared_ptr<Ingredient> addAbove(std::shared_ptr<Character> character) override;		
-    std::shared_ptr<Ingredient> addBelow(std::shared_ptr<Character> character) override;	
+    rendering::GreyBitmap render(int width, int height, Region region) const override;
+    const Ingredient* addLeft(CharacterId character) const override;
+    const Ingredient* addRight(CharacterId character) const override;	
+    const Ingredient* addAbove(CharacterId character) const override;		
+    const Ingredient* addBelow(CharacterId character) const override;	
 };
 
 } // namespace crafting
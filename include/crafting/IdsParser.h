@@ -0,0 +1,91 @@
+#ifndef IDS_PARSER_H
+#define IDS_PARSER_H
+
+#include "Operator.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A node of a parsed Ideographic Description Sequence.
+*/
+struct IdsNode {
+    // The operator of the node, or nullptr if the node is a single character.
+    const Operator* op;
+    // The character of the node if it is a single character, otherwise the operator character.
+    char32_t character;
+    // Whether the node was marked as an approximation with 〾.
+    bool approx;
+    uint8_t numChildren;
+    // Indices of the children, relative to the root of the tree.
+    uint32_t children[3];
+};
+
+/**
+ * @brief A view of a parsed Ideographic Description Sequence. The nodes are in pre-order, so the root is the first node.
+*/
+struct IdsTree {
+    const IdsNode* nodes;
+    size_t size;
+    const IdsNode& root() const { return nodes[0]; }
+};
+
+/**
+ * @brief Thrown if an Ideographic Description Sequence is malformed.
+*/
+class IdsSyntaxError : public std::runtime_error {
+private:
+    size_t mPosition;
+public:
+    IdsSyntaxError(const std::string& message, size_t position)
+        : std::runtime_error(message + " (at position " + std::to_string(position) + ")")
+        , mPosition(position)
+    { }
+    /**
+     * @brief Gets the index of the code point at which the error was detected.
+    */
+    size_t getPosition() const { return mPosition; }
+};
+
+/**
+ * @brief Parses Ideographic Description Sequences in a single pass with an explicit stack.
+ * The buffers are reused between calls, so parsing does not allocate once they have grown large enough.
+*/
+class IdsParser {
+private:
+    struct OpenNode {
+        uint32_t node;
+        int remaining;
+    };
+    std::vector<IdsNode> mNodes;
+    std::vector<OpenNode> openNodes;
+public:
+    /**
+     * @brief Parses an Ideographic Description Sequence.
+     * @param ids The sequence to parse.
+     * @return A view of the parsed tree, valid until the next call.
+     * @throws IdsSyntaxError If the sequence is empty, has too few or too many ingredients or 〾 is not followed by an operator.
+    */
+    IdsTree parse(std::u32string_view ids);
+    /**
+     * @brief Parses an Ideographic Description Sequence and appends its nodes to the given buffer.
+     * Child indices stay relative to the root, so the appended nodes form a tree starting at the returned offset.
+     * @return The offset of the root in the buffer.
+     * @throws IdsSyntaxError See parse.
+    */
+    size_t parseInto(std::u32string_view ids, std::vector<IdsNode>& out);
+};
+
+/**
+ * @brief Converts a parsed Ideographic Description Sequence back to its string representation.
+*/
+extern std::u32string idsToString(IdsTree tree);
+
+} // namespace crafting
+
+#endif // ifndef IDS_PARSER_H
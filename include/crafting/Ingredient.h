@@ -2,40 +2,89 @@
 #define INGREDIENT_H
 
 #include "Bitmap.h"
+#include "CharacterId.h"
+#include "Region.h"
+#include <cstdint>
 #include <string>
-#include <memory>
+#include <vector>
 
 namespace crafting {
 
 class Character;
 
+/**
+ * @brief The concrete type of an ingredient, so it can be told apart without RTTI.
+*/
+enum class IngredientKind : uint8_t {
+    EMPTY,
+    CHARACTER,
+    RECIPE
+};
+
 /**
  * @brief An interface for components of a recipe.
 */
 class Ingredient {
+private:
+    IngredientKind mKind;
+protected:
+    explicit Ingredient(IngredientKind kind) : mKind(kind) {}
 public:
+    /**
+     * @brief Gets the concrete type of the ingredient. An ingredient of kind CHARACTER is a Character,
+     * of kind RECIPE a Recipe and of kind EMPTY an EmptyIngredient.
+    */
+    IngredientKind getKind() const { return mKind; }
     virtual bool operator==(const Ingredient& other) const = 0;
     virtual operator std::u32string() const = 0;
     /**
      * @brief Render the ingredient as a bitmap with the given dimensions.
+     * @param region The region whose recipes characters without glyphs are rendered with.
     */
-    virtual rendering::GreyBitmap render(int width, int height) const = 0;
+    virtual rendering::GreyBitmap render(int width, int height, Region region) const = 0;
     /**
      * @brief Add a character to the left of the ingredient.
+     * @return The resulting ingredient, owned by the character table or the recipe interner.
     */
-    virtual std::shared_ptr<Ingredient> addLeft(std::shared_ptr<Character> character) = 0;
+    virtual const Ingredient* addLeft(CharacterId character) const = 0;
     /**
      * @brief Add a character to the right of the ingredient.
+     * @return The resulting ingredient, owned by the character table or the recipe interner.
     */	
-    virtual std::shared_ptr<Ingredient> addRight(std::shared_ptr<Character> character) = 0;	
+    virtual const Ingredient* addRight(CharacterId character) const = 0;	
     /**
      * @brief Add a character above the ingredient.
+     * @return The resulting ingredient, owned by the character table or the recipe interner.
     */	
-    virtual std::shared_ptr<Ingredient> addAbove(std::shared_ptr<Character> character) = 0;
+    virtual const Ingredient* addAbove(CharacterId character) const = 0;
     /**
      * @brief Add a character below the ingredient.
+     * @return The resulting ingredient, owned by the character table or the recipe interner.
     */		
-    virtual std::shared_ptr<Ingredient> addBelow(std::shared_ptr<Character> character) = 0;	
+    virtual const Ingredient* addBelow(CharacterId character) const = 0;	
+};
+
+/**
+ * @brief A read-only view of a sequence of ingredient pointers, e.g. the ingredients of a recipe.
+*/
+class IngredientList {
+private:
+    const Ingredient* const* mData;
+    size_t mSize;
+public:
+    IngredientList(const Ingredient* const* data, size_t size) : mData(data), mSize(size) {}
+    IngredientList(const std::vector<const Ingredient*>& ingredients) : mData(ingredients.data()), mSize(ingredients.size()) {}
+    /**
+     * @brief Views the ingredients of an array. Only valid as long as the array is.
+    */
+    template<size_t N>
+    IngredientList(const Ingredient* const (&ingredients)[N]) : mData(ingredients), mSize(N) {}
+
+    const Ingredient* const* begin() const { return mData; }
+    const Ingredient* const* end() const { return mData + mSize; }
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    const Ingredient* operator[](size_t index) const { return mData[index]; }
 };
 
 } // namespace crafting
@@ -0,0 +1,63 @@
+#ifndef INGREDIENT_BUILDER_H
+#define INGREDIENT_BUILDER_H
+
+#include "CharacterId.h"
+#include "Ingredient.h"
+#include <cstddef>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief Builds an ingredient step by step, e.g. on the crafting board, and keeps every version so steps can be undone and redone.
+ * Ingredients are immutable and interned, so a new version shares everything but the new node with the previous one,
+ * and keeping a version only costs a pointer. The nodes stay in the recipe interner until it is cleared, also after the
+ * builder is gone, see RecipeInterner. Builders on different threads can be used at the same time.
+*/
+class IngredientBuilder {
+private:
+    // Every version since the start, the first one is the empty ingredient.
+    std::vector<const Ingredient*> versions;
+    // The index of the current version, versions after it can be redone.
+    size_t current;
+    /**
+     * @brief Makes the ingredient the current version, dropping the versions that could be redone.
+    */
+    const Ingredient& push(const Ingredient* ingredient);
+public:
+    /**
+     * @brief Constructs a builder with the empty ingredient.
+    */
+    IngredientBuilder();
+
+    const Ingredient& addLeft(CharacterId character) { return push(versions[current]->addLeft(character)); }
+    const Ingredient& addRight(CharacterId character) { return push(versions[current]->addRight(character)); }
+    const Ingredient& addAbove(CharacterId character) { return push(versions[current]->addAbove(character)); }
+    const Ingredient& addBelow(CharacterId character) { return push(versions[current]->addBelow(character)); }
+
+    /**
+     * @brief Goes back to the previous version.
+     * @return True if there was a previous version, false otherwise.
+    */
+    bool undo();
+    /**
+     * @brief Goes forward to the version that was last undone.
+     * @return True if there was such a version, false otherwise.
+    */
+    bool redo();
+    bool canUndo() const { return current > 0; }
+    bool canRedo() const { return current + 1 < versions.size(); }
+    /**
+     * @brief Starts over with the empty ingredient and forgets all versions.
+    */
+    void clear();
+
+    /**
+     * @brief Gets the current version of the ingredient.
+    */
+    const Ingredient& get() const { return *versions[current]; }
+};
+
+} // namespace crafting
+
+#endif // ifndef INGREDIENT_BUILDER_H
@@ -0,0 +1,83 @@
+#ifndef INPUT_CODE_INDEX_H
+#define INPUT_CODE_INDEX_H
+
+#include "CharacterId.h"
+#include "DictionaryData.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A character found by InputCodeIndex::find, with the whole code it is typed with.
+*/
+struct InputCodeMatch {
+    CharacterId character;
+    // The packed code, see unpackCangjie and unpackFourCornerCode.
+    uint32_t code;
+};
+
+/**
+ * @brief Finds characters by the beginning of an input method code, e.g. a Cangjie or Four-Corner code, while it is typed.
+ *
+ * The codes of all characters are in one array, grouped by kFrequency from the most frequent characters to the ones
+ * without a frequency, and sorted by packed code within a group. Packed codes sort like the codes, so the codes
+ * starting with a prefix are a range of every group, found by binary search. Going through the groups in order
+ * gives the most frequent matches first, so finding the best k matches stops after k of them instead of looking
+ * at all matches of a short prefix.
+*/
+class InputCodeIndex {
+private:
+    // kFrequency 1 to 5, then characters without a frequency.
+    static constexpr int NUM_GROUPS = 6;
+
+    DictionaryField field;
+    // The codes of all characters, sorted by group, code and character.
+    std::vector<InputCodeMatch> entries;
+    // Where each group starts in entries, the last one is the end.
+    std::array<uint32_t, NUM_GROUPS + 1> groupOffsets{};
+
+    /**
+     * @brief Gets the range of packed codes starting with a prefix.
+    */
+    std::pair<uint32_t, uint32_t> prefixRange(std::string_view prefix) const;
+public:
+    /**
+     * @brief Constructs an empty index.
+     * @param field The field of the dictionary data with the codes, DictionaryField::CANGJIE or DictionaryField::FOUR_CORNER_CODE.
+    */
+    explicit InputCodeIndex(DictionaryField field) : field(field) {}
+
+    /**
+     * @brief Builds the index from the codes and frequencies in dictionaryData. Has to be called again if it is reloaded.
+    */
+    void build();
+
+    /**
+     * @brief Finds the characters with a code starting with the prefix, the most frequent first
+     * and then by code, so a character typed with the prefix itself comes before longer codes of the same frequency.
+     * Characters with several matching codes are only found with the first one.
+     * @param prefix The typed part of a code, e.g. "dd" for Cangjie or "409" for Four-Corner codes.
+     * @param maxResults The maximum number of characters returned.
+    */
+    std::vector<InputCodeMatch> find(std::string_view prefix, size_t maxResults = 20) const;
+    /**
+     * @brief Gets the number of codes starting with the prefix.
+    */
+    size_t count(std::string_view prefix) const;
+
+    /**
+     * @brief Gets the number of codes in the index.
+    */
+    size_t size() const { return entries.size(); }
+};
+
+// The Cangjie and Four-Corner codes of the loaded characters, built by loading::loadAll.
+extern InputCodeIndex cangjieIndex;
+extern InputCodeIndex fourCornerIndex;
+
+} // namespace crafting
+
+#endif // ifndef INPUT_CODE_INDEX_H
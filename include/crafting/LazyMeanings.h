@@ -0,0 +1,73 @@
+#ifndef LAZY_MEANINGS_H
+#define LAZY_MEANINGS_H
+
+#include "CharacterId.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief Meanings that are only read from the readings file when they are first needed.
+ *
+ * The file stays memory-mapped and only the offset of the definition line of every character is kept.
+ * Character::getMeanings registers the meanings of a character the first time it is called for it,
+ * with the same rules as registerMeanings, so the result is the same as when loading all meanings up front.
+ * Loading is guarded by a mutex, so getMeanings can be called from several threads at once. The details of a character
+ * are already allocated when its line is added, so loading only appends to their meanings.
+*/
+class LazyMeanings {
+private:
+    util::MappedFile file;
+    // The offset of the definition line of every character by id, plus one. 0 if there is none or it was loaded already.
+    std::vector<uint32_t> offsets;
+    // Only lowered once a character's meanings are registered, so no meanings are added anymore once it is 0.
+    std::atomic<size_t> numPending{0};
+    std::mutex mutex;
+
+    /**
+     * @brief Registers the meanings from the line at the given offset.
+    */
+    void loadLine(uint32_t offset);
+public:
+    /**
+     * @brief Maps the readings file, dropping all pending meanings of a previously opened file. Not thread-safe.
+     * @return True if the file was mapped, false otherwise.
+    */
+    bool open(const std::string& path);
+    /**
+     * @brief Gets the content of the mapped file, to find the definition lines in.
+    */
+    std::string_view view() const { return file.view(); }
+    /**
+     * @brief Remembers the line holding the meanings of a character, to register them when they are needed. Not thread-safe.
+     * @param offset The offset of the start of the line in the mapped file.
+    */
+    void add(CharacterId character, uint32_t offset);
+    /**
+     * @brief Registers the meanings of the character if they were not loaded yet.
+     * While meanings are pending, other threads may be adding meanings to the meaning pool and to the meanings of characters,
+     * so these must only be read while the returned lock is held.
+     * @return A lock on the lazy meanings, or an empty lock if all meanings are loaded.
+    */
+    std::unique_lock<std::mutex> load(CharacterId character);
+    /**
+     * @brief Registers all meanings that were not loaded yet. Afterwards, load never locks.
+    */
+    void loadAll();
+    /**
+     * @brief Gets the number of characters whose meanings were not loaded yet.
+    */
+    size_t size() const { return numPending; }
+};
+
+// The meanings waiting to be loaded, filled by loading::loadMeaningsLazily.
+extern LazyMeanings lazyMeanings;
+
+} // namespace crafting
+
+#endif // ifndef LAZY_MEANINGS_H
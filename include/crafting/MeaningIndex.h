@@ -0,0 +1,97 @@
+#ifndef MEANING_INDEX_H
+#define MEANING_INDEX_H
+
+#include "CharacterId.h"
+#include "PostingLists.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief A character found by MeaningIndex::search.
+*/
+struct MeaningMatch {
+    CharacterId character;
+    float score;
+};
+
+/**
+ * @brief How MeaningIndex::search matches and ranks the words of a query.
+*/
+struct MeaningQuery {
+    // Whether a character has to match all words of the query, or any of them.
+    bool matchAll = true;
+    // Whether the last word of the query also matches longer words, e.g. "wat" matches "water", for searching while typing.
+    bool prefixLastWord = true;
+    // Whether frequently used characters are ranked higher, by their kFrequency in DictionaryData.
+    bool boostFrequent = true;
+    // The maximum number of characters returned.
+    size_t maxResults = 20;
+};
+
+/**
+ * @brief An inverted index from the words of the meanings of the characters to the characters, ranked with BM25.
+ *
+ * Meanings are split into words at everything that is not a letter or digit, and words are lowercased,
+ * e.g. "tree; wood, lumber" into "tree", "wood" and "lumber". The vocabulary is sorted, so a prefix of a word
+ * is a range of it, and the posting list of every word is sorted by character id, so the lists of several words
+ * are merged in a single pass. Words ending with * in a query match as a prefix, too.
+*/
+class MeaningIndex {
+private:
+    struct Posting {
+        CharacterId character;
+        // How often the word appears in the meanings of the character.
+        uint32_t count;
+    };
+    // All words, sorted.
+    std::vector<std::string> words;
+    // The characters whose meanings contain each word, by the index of the word.
+    util::PostingLists<Posting> postings;
+    // The number of words in the meanings of each character, by id.
+    std::vector<uint32_t> lengths;
+    // The number of characters with meanings and their average number of words.
+    uint32_t numDocuments = 0;
+    float averageLength = 0;
+
+    /**
+     * @brief Gets the range of words matching a word of a query.
+    */
+    std::pair<size_t, size_t> findWords(std::string_view word, bool prefix) const;
+    /**
+     * @brief Scores the characters matching a word of a query, sorted by character id.
+    */
+    void scoreWord(std::string_view word, bool prefix, std::vector<MeaningMatch>& out) const;
+public:
+    /**
+     * @brief Splits a text into lowercase words, the way meanings and queries are split.
+    */
+    static void tokenize(std::string_view text, std::vector<std::string>& out);
+
+    /**
+     * @brief Builds the index from the meanings of all characters. Has to be called again if meanings are added.
+     * Loads all meanings that are loaded lazily, see LazyMeanings.
+    */
+    void build();
+
+    /**
+     * @brief Finds the characters whose meanings match the query, best first.
+     * @param text The words to search for, split like meanings.
+    */
+    std::vector<MeaningMatch> search(std::string_view text, const MeaningQuery& query = {}) const;
+
+    /**
+     * @brief Gets the number of distinct words in the index.
+    */
+    size_t size() const { return words.size(); }
+};
+
+// The index of the meanings of the loaded characters, built by loading::loadAll.
+extern MeaningIndex meaningIndex;
+
+} // namespace crafting
+
+#endif // ifndef MEANING_INDEX_H
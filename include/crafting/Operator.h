@@ -0,0 +1,60 @@
+#ifndef OPERATOR_H
+#define OPERATOR_H
+
+namespace crafting {
+
+/**
+ * @brief An operator that defines how to combine ingredients in a recipe.
+*/
+struct Operator {
+    // The character that represents the operator.
+    char32_t operator_c;
+    // The number of ingredients that the operator takes.
+    int num_ingredients;
+    // Whether the ingredients must be in a specific order.
+    bool ordered;
+    // Whether the operator has been initialized.
+    constexpr operator bool() const { return operator_c; }
+};
+
+// The operators of the Ideographic Description Characters block, indexed by their offset from U+2FF0 ⿰.
+inline constexpr Operator ideographicOperators[] = {
+    {U'⿰', 2, true},
+    {U'⿱', 2, true},
+    {U'⿲', 3, true},
+    {U'⿳', 3, true},
+    {U'⿴', 2, true},
+    {U'⿵', 2, true},
+    {U'⿶', 2, true},
+    {U'⿷', 2, true},
+    {U'⿸', 2, true},
+    {U'⿹', 2, true},
+    {U'⿺', 2, true},
+    {U'⿻', 2, false}
+};
+inline constexpr Operator mirrorOperator{U'↔', 1, true};
+inline constexpr Operator rotateOperator{U'↷', 1, true};
+inline constexpr Operator subtractOperator{U'⊖', 2, true};
+
+// Marks the following recipe as an approximation.
+constexpr char32_t APPROX_MARKER = U'〾';
+
+/**
+ * @brief Looks up the operator represented by a character, without any hashing or allocation.
+ * @return A pointer to the operator, or nullptr if the character does not represent an operator.
+*/
+constexpr const Operator* findOperator(char32_t character) {
+    if(character >= U'⿰' && character <= U'⿻') {
+        return &ideographicOperators[character - U'⿰'];
+    }
+    switch(character) {
+        case U'↔': return &mirrorOperator;
+        case U'↷': return &rotateOperator;
+        case U'⊖': return &subtractOperator;
+        default: return nullptr;
+    }
+}
+
+} // namespace crafting
+
+#endif // ifndef OPERATOR_H
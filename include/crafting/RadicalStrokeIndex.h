@@ -0,0 +1,85 @@
+#ifndef RADICAL_STROKE_INDEX_H
+#define RADICAL_STROKE_INDEX_H
+
+#include "CharacterId.h"
+#include "ArrayView.h"
+#include <cstdint>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief The Kangxi radical a character is indexed under in dictionaries and its stroke counts.
+*/
+struct RadicalStrokes {
+    // The number of the radical from 1 to 214, 0 if the character has no data.
+    uint8_t radical;
+    // The strokes of the radical as it is written in the character, e.g. 3 for 氵 but 4 for 水.
+    uint8_t radicalStrokes;
+    // The strokes of the character besides the radical.
+    uint8_t residualStrokes;
+    // The strokes of the whole character.
+    uint8_t totalStrokes;
+};
+
+/**
+ * @brief The radicals and stroke counts of the characters, with the characters sorted by radical and by stroke count,
+ * so that dictionary queries like "all characters with radical 85 and at most 8 residual strokes" are a range of a sorted array.
+*/
+class RadicalStrokeIndex {
+private:
+    static constexpr int NUM_RADICALS = 214;
+    static constexpr int MAX_STROKES = 255;
+
+    // The data of every character, by id.
+    std::vector<RadicalStrokes> entries;
+    // The characters with data, sorted by radical, residual strokes and id. radicalOffsets[r] is where radical r starts.
+    std::vector<CharacterId> byRadical;
+    std::vector<uint32_t> radicalOffsets;
+    // The characters with data, sorted by total strokes and id. strokeOffsets[s] is where s strokes start.
+    std::vector<CharacterId> byStrokes;
+    std::vector<uint32_t> strokeOffsets;
+public:
+    /**
+     * @brief Sets the radical and stroke counts of a character, if it has none yet.
+     * @return True if the data was set, false if the character already had data or the radical is out of range.
+    */
+    bool add(CharacterId character, uint8_t radical, uint8_t radicalStrokes, uint8_t residualStrokes);
+
+    /**
+     * @brief Builds the sorted indexes from the added data. Has to be called again if data is added afterwards.
+    */
+    void build();
+
+    /**
+     * @brief Gets the radical and stroke counts of a character, with radical 0 if there are none.
+    */
+    RadicalStrokes get(CharacterId character) const {
+        return uint32_t(character) < entries.size() ? entries[uint32_t(character)] : RadicalStrokes{};
+    }
+    /**
+     * @brief Gets the characters with the given radical and residual strokes, sorted by residual strokes.
+     * @param radical The number of the radical from 1 to 214.
+    */
+    util::ArrayView<CharacterId> getByRadical(int radical, int minResidualStrokes = 0, int maxResidualStrokes = MAX_STROKES) const;
+    /**
+     * @brief Gets the characters with the given total strokes, sorted by strokes.
+    */
+    util::ArrayView<CharacterId> getByStrokes(int minStrokes, int maxStrokes) const;
+    /**
+     * @brief Sorts characters by total strokes, e.g. the items of an inventory. Characters without data come last.
+     * Characters with the same strokes keep their order.
+    */
+    void sortByStrokes(std::vector<CharacterId>& characters) const;
+    /**
+     * @brief Gets the number of characters with data.
+    */
+    size_t size() const { return byRadical.size(); }
+};
+
+// The radicals and stroke counts of the loaded characters, built by loading::loadAll.
+extern RadicalStrokeIndex radicalStrokeIndex;
+
+} // namespace crafting
+
+#endif // ifndef RADICAL_STROKE_INDEX_H
@@ -2,87 +2,101 @@
 #define RECIPE_H
 
 #include "Ingredient.h"
+#include "Operator.h"
+#include "IdsParser.h"
 #include <initializer_list>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
-#include <memory>
 
 namespace crafting {
 
-/**
- * @brief An operator that defines how to combine ingredients in a recipe.
-*/
-struct {
-    // The character that represents the operator.
-    char32_t operator_c;
-    // The number of ingredients that the operator takes.
-    int num_ingredients;
-    // Whether the ingredients must be in a specific order.
-    bool ordered;
-    // Whether the operator has been initialized.
-    operator bool() { return operator_c; }
-} typedef Operator;
-
-// A hash map used to obtain an operator from its character representation.
-extern std::unordered_map<char32_t, Operator> operators;
-
 /**
  * @brief Ingredients put together with an operator to form a recipe.
 */
-class Recipe : public Ingredient, public std::enable_shared_from_this<Recipe> {
+class Recipe : public Ingredient {
 private:
-    std::vector<std::shared_ptr<Ingredient>> mIngredients;
-    Operator& mOperator;
+    // The ingredients are owned by the character table and the recipe interner. Operators take at most 3 ingredients.
+    const Ingredient* mIngredients[3];
+    uint8_t mNumIngredients;
+    const Operator& mOperator;
     bool approx;
+    // Unique id of the recipe tree. See RecipeInterner.
+    uint32_t mId;
+    // Id of the canonical key of the recipe, shared by all recipes that are the same for crafting.
+    uint32_t mCanonicalId;
+    // Hash of the canonical key.
+    uint64_t mHash;
+    /**
+     * @brief Looks up or assigns the id of the recipe, called at the end of every constructor.
+    */
+    void assignId();
+    /**
+     * @brief Gets the node of the recipe interner that is equal to this recipe, to be used as an ingredient of a new recipe.
+    */
+    const Recipe* interned() const;
 public:
     /**
      * @brief Constructs a new Recipe object.
      * @param ingredient A single ingredient to be used in the recipe.
     */
     Recipe(char32_t ingredient);
-    /**
-     * @brief Constructs a new Recipe object.
-     * @param op The operator to use in the recipe.
-     * @param ingredients The ingredients to use in the recipe.
-     * @throws std::runtime_error If the number of ingredients does not match the operator or the operator char is invalid.
-    */
-    Recipe(char32_t op, std::initializer_list<std::shared_ptr<Ingredient>> ingredients);
     /**
      * @brief Constructs a new Recipe object.	
      * @param op The operator to use in the recipe.
      * @param ingredients The ingredients to use in the recipe.
+     * @param approx Whether the recipe is an approximation.
      * @throws std::runtime_error If the number of ingredients does not match the operator or the operator char is invalid.
     */
-    Recipe(char32_t op, const std::vector<std::shared_ptr<Ingredient>>& ingredients);
+    Recipe(char32_t op, IngredientList ingredients, bool approx = false);
     /**
      * @brief Constructs a new Recipe object.
      * @param recipeString The string representation of the recipe.
-     * @throws std::runtime_error If the first character of the recipe string or of substrings representing recipes are not operators.
-     * @throws std::runtime_error If the number of ingredients does not match the operator.
+     * @throws IdsSyntaxError If the recipe string is malformed, e.g. if the number of ingredients does not match the operators.
+     * @throws std::runtime_error If the first character of the recipe string is not an operator.
     */
-    Recipe(std::u32string recipeString);
+    Recipe(std::u32string_view recipeString);
+    /**
+     * @brief Constructs a new Recipe object from an already parsed recipe string.
+     * @param tree The parsed recipe string.
+     * @throws std::runtime_error If the root of the tree is not an operator.
+    */
+    Recipe(IdsTree tree);
     /**
      * @brief Gets the vector of pointers to ingredients used in the recipe.
     */
-    const std::vector<std::shared_ptr<Ingredient>>& getIngredients() const { return mIngredients; }
+    IngredientList getIngredients() const { return IngredientList(mIngredients, mNumIngredients); }
     /**
      * @brief Gets the operator used in the recipe.
     */
-    Operator& getOperator() const { return mOperator; }
+    const Operator& getOperator() const { return mOperator; }
     /**
      * @brief Gets whether the recipe is an approximation.
     */
     bool getApprox() const { return approx; }
+    /**
+     * @brief Gets the id of the recipe tree. Two recipes have the same id exactly if their trees are identical.
+    */
+    uint32_t getId() const { return mId; }
+    /**
+     * @brief Gets the id of the canonical key of the recipe. Two recipes are equal exactly if their canonical ids are equal,
+     * e.g. ⿰木⿰木木 and ⿲木木木, or ⿻十人 and ⿻人十.
+    */
+    uint32_t getCanonicalId() const { return mCanonicalId; }
+    /**
+     * @brief Gets the precomputed, order-aware hash of the canonical key of the recipe.
+    */
+    uint64_t getHash() const { return mHash; }
     bool operator==(const Ingredient& other) const override;
     bool operator==(const Recipe& other) const;
     operator std::u32string() const override;
 
-    std::shared_ptr<Ingredient> addLeft(std::shared_ptr<Character> character) override;
-    std::shared_ptr<Ingredient> addRight(std::shared_ptr<Character> character) override;
-    std::shared_ptr<Ingredient> addAbove(std::shared_ptr<Character> character) override;
-    std::shared_ptr<Ingredient> addBelow(std::shared_ptr<Character> character) override;
+    const Ingredient* addLeft(CharacterId character) const override;
+    const Ingredient* addRight(CharacterId character) const override;
+    const Ingredient* addAbove(CharacterId character) const override;
+    const Ingredient* addBelow(CharacterId character) const override;
 
-    rendering::GreyBitmap render(int width, int height) const override;
+    rendering::GreyBitmap render(int width, int height, Region region) const override;
 };
 
 } // namespace crafting
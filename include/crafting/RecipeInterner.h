@@ -0,0 +1,160 @@
+#ifndef RECIPE_INTERNER_H
+#define RECIPE_INTERNER_H
+
+#include "Ingredient.h"
+#include "Arena.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace crafting {
+
+class Recipe;
+
+/**
+ * @brief Identifies a recipe node by its operator, approximation flag and the identities of its direct ingredients.
+ * Since ingredients are identified by their own ids, two keys are equal exactly if the whole recipe trees are equal.
+*/
+struct RecipeKey {
+    // Set in an ingredient identity if it is a recipe id rather than a code point.
+    static constexpr uint64_t RECIPE_BIT = uint64_t(1) << 32;
+
+    char32_t op;
+    bool approx;
+    uint8_t numIngredients;
+    // The code point for characters, the recipe id combined with RECIPE_BIT for recipes.
+    uint64_t ingredients[3];
+
+    bool operator==(const RecipeKey& other) const;
+    /**
+     * @brief Computes the structural hash of the recipe node this key identifies.
+    */
+    uint64_t hash() const;
+};
+
+/**
+ * @brief Hash-consing table for recipe nodes. Every distinct recipe tree gets a unique id, and interned nodes exist only once,
+ * so identical sub-recipes of different characters share the same node and equality of recipes is a comparison of ids.
+ *
+ * Besides the structural id, every tree gets a canonical id, which is shared by all trees that are the same for crafting:
+ * - ingredients of unordered operators like ⿻ are sorted,
+ * - ⿰ with one ⿰ ingredient is flattened into ⿲, ⿱ with one ⿱ ingredient into ⿳, the way addLeft/addAbove and co. build them.
+ *
+ * Interned nodes are never freed one by one, they live until clear is called. Besides loading, nodes are interned whenever
+ * an ingredient is built, e.g. by IngredientBuilder or RecipeMatcher::Cursor, so the memory grows with the number of
+ * distinct ingredients built in all sessions together; building an ingredient that was built before reuses its node.
+ * All members lock the interner, so sessions on different threads can build ingredients at the same time.
+*/
+class RecipeInterner {
+private:
+    // The structural key of every id. Index 0 is unused.
+    std::vector<RecipeKey> keys{RecipeKey{}};
+    // Open addressing hash table of the structural ids, 0 for empty slots. Its size is a power of two.
+    std::vector<uint32_t> idIndex;
+    // Storage of the shared nodes. Nodes are created bottom-up while loading, so recipes lie close to their sub-recipes.
+    util::Arena<Recipe> arena;
+    // The shared node of every id, null if no node has been interned for it yet. Index 0 is unused.
+    std::vector<const Recipe*> nodes{nullptr};
+    // The canonical id of every structural id.
+    std::vector<uint32_t> canonicalIds{0};
+    // Canonical keys refer to canonical ids of their ingredients instead of structural ones.
+    std::vector<RecipeKey> canonicalKeys{RecipeKey{}};
+    std::vector<uint64_t> canonicalHashes{0};
+    // Open addressing hash table of the canonical ids, like idIndex.
+    std::vector<uint32_t> canonicalIndex;
+    // Guards all of the above. Recursive, since constructing a node in intern gets its id through getId.
+    mutable std::recursive_mutex mutex;
+    /**
+     * @brief Computes the canonical key of a structural key and gets its canonical id.
+    */
+    uint32_t canonicalize(const RecipeKey& key);
+    /**
+     * @brief Flattens and sorts a key whose recipe ingredients are canonical ids already.
+    */
+    RecipeKey makeCanonical(RecipeKey key) const;
+public:
+    /**
+     * @brief Gets the id of the recipe tree with the given key, assigning a new one if the tree has not been seen before.
+    */
+    uint32_t getId(const RecipeKey& key);
+    /**
+     * @brief Gets the shared node for the given recipe, constructing it if it does not exist yet.
+     * @throws std::runtime_error If the number of ingredients does not match the operator or the operator char is invalid.
+    */
+    const Recipe* intern(char32_t op, IngredientList ingredients, bool approx = false);
+    /**
+     * @brief Gets the shared node with the given id, or nullptr if it has not been interned.
+    */
+    const Recipe* getRecipe(uint32_t id) const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return id < nodes.size() ? nodes[id] : nullptr;
+    }
+    /**
+     * @brief Gets the canonical id of the recipe tree with the given structural id.
+    */
+    uint32_t getCanonicalId(uint32_t id) const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return canonicalIds[id];
+    }
+    /**
+     * @brief Gets the canonical id of a key that refers to canonical ids of its recipe ingredients,
+     * assigning a new one if no such canonical recipe has been seen before. Does not create any recipe node.
+    */
+    uint32_t internCanonical(const RecipeKey& key);
+    /**
+     * @brief Like internCanonical, but only looks the key up.
+     * @return The canonical id, or 0 if no such canonical recipe has been seen.
+    */
+    uint32_t findCanonical(const RecipeKey& key) const;
+    /**
+     * @brief Gets the canonical key with the given canonical id. Returned by value, since other threads may add keys meanwhile.
+    */
+    RecipeKey getCanonicalKey(uint32_t canonicalId) const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return canonicalKeys[canonicalId];
+    }
+    /**
+     * @brief Gets the hash of the canonical key with the given canonical id.
+    */
+    uint64_t getCanonicalHash(uint32_t canonicalId) const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return canonicalHashes[canonicalId];
+    }
+    /**
+     * @brief Gets the number of distinct recipe trees seen so far.
+    */
+    size_t size() const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return keys.size() - 1;
+    }
+    /**
+     * @brief Gets the number of distinct canonical recipes seen so far.
+    */
+    size_t canonicalSize() const {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return canonicalKeys.size() - 1;
+    }
+    /**
+     * @brief Makes room for the given number of recipe trees, e.g. before loading a database image.
+    */
+    void reserve(size_t numRecipes);
+    /**
+     * @brief Frees all nodes and forgets all ids at once. Every recipe built before, including the ones in the
+     * recipe map and the characters, must not be used anymore afterwards.
+    */
+    void clear();
+};
+
+// The interner used by all recipes. Unlike the other crafting maps, it is thread-safe, since playing builds new recipes.
+extern RecipeInterner recipeInterner;
+
+/**
+ * @brief Computes the structural key of a recipe node from its parts. The ingredients keep their order even for
+ * unordered operators; only the canonical key sorts them.
+*/
+extern RecipeKey makeRecipeKey(char32_t op, bool approx, IngredientList ingredients);
+
+} // namespace crafting
+
+#endif // ifndef RECIPE_INTERNER_H
@@ -0,0 +1,143 @@
+#ifndef RECIPE_MATCHER_H
+#define RECIPE_MATCHER_H
+
+#include "CharacterId.h"
+#include "Ingredient.h"
+#include "Region.h"
+#include "ArrayView.h"
+#include "PostingLists.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief Tells which recipes of the recipe map can still be reached while an ingredient is built step by step
+ * with addLeft, addRight, addAbove and addBelow.
+ *
+ * Every add wraps the ingredient built so far into a new recipe, so a recipe can be reached from every ingredient
+ * it can be built from this way, e.g. ⿱木林 from 木, 林 and ⿰木木, and ⿲口口口 from 口 and ⿰口口. These construction
+ * states are collected for every recipe of the component index when the matcher is built. Since ingredients are
+ * interned, an add is a lookup of the resulting state, and the recipes and characters still reachable from it are stored
+ * with the state, so they are known right after every step. Variants of the same character lead to the same states,
+ * so the reachable recipes are those of the whole variant class. The results of the ingredient itself are looked up
+ * by its canonical id instead, the same way crafting it does, see findRecipeResults.
+ *
+ * The states hold the recipes of all regions, together with the regions they are used in, so that players of
+ * different regions can share the matcher. Every session only sees the recipes of its own region.
+*/
+class RecipeMatcher {
+private:
+    static constexpr uint32_t NO_STATE = UINT32_MAX;
+    static constexpr uint32_t NO_RECIPE = UINT32_MAX;
+    // The states of characters, by the id of the representative of their variant class, see VariantClasses.
+    std::vector<uint32_t> characterStates;
+    // The states of recipes, by recipe class.
+    std::unordered_map<uint32_t, uint32_t> recipeStates;
+    // The recipes that can be reached from each state, as indices into the component index.
+    util::PostingLists<uint32_t> reachableRecipes;
+    // The characters made by those recipes, without duplicates.
+    util::PostingLists<CharacterId> reachableResults;
+    // The regions those recipes make each of the characters in, in the same order.
+    util::PostingLists<RegionMask> reachableResultRegions;
+    uint32_t numStates = 0;
+    // The index of every recipe of the component index, by canonical id.
+    std::unordered_map<uint32_t, uint32_t> recipeIndices;
+    // The regions every recipe of the component index makes any of its results in.
+    std::vector<RegionMask> recipeRegions;
+    // The recipes and characters reachable from the empty ingredient, which are all of them.
+    std::vector<uint32_t> allRecipes;
+    std::vector<CharacterId> allResults;
+    std::vector<RegionMask> allResultRegions;
+
+    /**
+     * @brief Gets the state of an ingredient, assigning a new one if requested.
+     * @return The state, or NO_STATE if the ingredient has none and create is false.
+    */
+    uint32_t getState(const Ingredient& ingredient, bool create = false);
+    uint32_t findState(const Ingredient& ingredient) const;
+    /**
+     * @brief Gets the recipe of the component index that crafting the ingredient uses: the ingredient itself if it is
+     * in the recipe map, otherwise a recipe that only differs by variants.
+     * @return The index of the recipe in the component index, or NO_RECIPE if there is none.
+    */
+    uint32_t findRecipe(const Ingredient& ingredient) const;
+    /**
+     * @brief Collects the states the ingredient can be built from, including itself.
+    */
+    void collectStates(const Ingredient& ingredient, std::vector<uint32_t>& states);
+public:
+    /**
+     * @brief A construction session, following an ingredient as it is built.
+    */
+    class Cursor {
+    private:
+        const RecipeMatcher* matcher;
+        // The region whose recipes the session crafts with.
+        Region region;
+        const Ingredient* ingredient;
+        uint32_t state;
+    public:
+        /**
+         * @brief Starts a session with the empty ingredient.
+         * @param region The region whose recipes are matched.
+        */
+        Cursor(const RecipeMatcher& matcher, Region region);
+
+        /**
+         * @brief Moves the cursor to another ingredient, e.g. the one of an IngredientBuilder after an undo.
+         * @return True if recipes can still be reached from it, false otherwise.
+        */
+        bool moveTo(const Ingredient* next);
+
+        bool addLeft(CharacterId character) { return moveTo(ingredient->addLeft(character)); }
+        bool addRight(CharacterId character) { return moveTo(ingredient->addRight(character)); }
+        bool addAbove(CharacterId character) { return moveTo(ingredient->addAbove(character)); }
+        bool addBelow(CharacterId character) { return moveTo(ingredient->addBelow(character)); }
+        /**
+         * @brief Starts over with the empty ingredient.
+        */
+        void reset();
+
+        /**
+         * @brief Gets the ingredient built so far.
+        */
+        const Ingredient& getIngredient() const { return *ingredient; }
+        /**
+         * @brief Gets the region whose recipes are matched.
+        */
+        Region getRegion() const { return region; }
+        /**
+         * @brief Gets the recipes that can still be reached by adding to the ingredient and make something in the region,
+         * as indices into the component index.
+        */
+        std::vector<uint32_t> getReachableRecipes() const;
+        /**
+         * @brief Gets the characters made in the region by the recipes that can still be reached, ordered by id.
+        */
+        std::vector<CharacterId> getReachableResults() const;
+        /**
+         * @brief Gets the characters the ingredient makes as it is in the region, the same ones crafting it gives.
+        */
+        std::vector<CharacterId> getResults() const;
+    };
+
+    /**
+     * @brief Builds the matcher from the component index. Has to be called again if the index is rebuilt.
+    */
+    void build();
+
+    /**
+     * @brief Starts a construction session.
+     * @param region The region whose recipes are matched, e.g. the one of the player, see player::Player::getRegion.
+    */
+    Cursor start(Region region) const { return Cursor(*this, region); }
+};
+
+// The matcher for the loaded recipes, built by loading::loadAll.
+extern RecipeMatcher recipeMatcher;
+
+} // namespace crafting
+
+#endif // ifndef RECIPE_MATCHER_H
@@ -0,0 +1,53 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace crafting {
+
+/**
+ * @brief The regions of the source references in the IDS files, e.g. the J in ^⿰木木$(GHJKTV).
+ * See PREFERRED_CHARACTER_VARIANT in config.h for their meaning.
+*/
+enum class Region : uint8_t {
+    G, H, J, K, M, P, S, T, U, B, V,
+    COUNT
+};
+
+// A set of regions, one bit per Region.
+using RegionMask = uint16_t;
+
+constexpr RegionMask ALL_REGIONS = (1 << int(Region::COUNT)) - 1;
+
+constexpr RegionMask regionBit(Region region) {
+    return RegionMask(1 << int(region));
+}
+
+/**
+ * @brief Gets the region of a source reference letter.
+ * @return True if the letter is one of the letters listed in config.h, false otherwise.
+*/
+bool regionFromLetter(char letter, Region& region);
+
+/**
+ * @brief Gets the regions of the source references of a recipe, e.g. (GHJKTV). Unknown letters are ignored.
+*/
+RegionMask parseRegions(std::string_view flags);
+
+/**
+ * @brief Gets the region whose recipes are used when no other one is chosen, PREFERRED_CHARACTER_VARIANT.
+ * All regions are kept loaded, so every player can craft with the recipes of its own region, see player::Player::setRegion.
+*/
+Region getDefaultRegion();
+
+/**
+ * @brief Whether a recipe with the given regions is used in the given region.
+*/
+constexpr bool isActiveIn(RegionMask regions, Region region) {
+    return regions & regionBit(region);
+}
+
+} // namespace crafting
+
+#endif // ifndef REGION_H
@@ -0,0 +1,86 @@
+#ifndef VARIANT_CLASSES_H
+#define VARIANT_CLASSES_H
+
+#include "CharacterId.h"
+#include "Recipe.h"
+#include "ArrayView.h"
+#include "PostingLists.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace crafting {
+
+/**
+ * @brief Groups characters that are variants of each other, like 亻 and 人 or 门 and 門, into classes,
+ * so they can count as the same character when crafting. Every class is represented by the character
+ * with the lowest code point in it, and comparing the representatives compares the classes.
+ *
+ * Recipes are grouped the same way: two recipes are in the same class if they only differ by variants.
+ * Until build is called, every character and recipe is in a class of its own.
+*/
+class VariantClasses {
+private:
+    // The union-find forest the classes are collected in, by character id.
+    std::vector<uint32_t> parents;
+    // The representative of the class of every character, by id.
+    std::vector<CharacterId> representatives;
+    // The characters of every class, by the id of its representative.
+    util::PostingLists<CharacterId> members;
+    // The class of the recipes of the recipe map and their sub-recipes, by structural recipe id, 0 if not computed.
+    std::vector<uint32_t> recipeClasses;
+    // A recipe of the recipe map for every recipe class.
+    std::unordered_map<uint32_t, const Recipe*> recipesByClass;
+
+    uint32_t findRoot(uint32_t id);
+public:
+    /**
+     * @brief Puts the two characters into the same class. Takes effect once build is called.
+    */
+    void unite(CharacterId a, CharacterId b);
+    /**
+     * @brief Finds the representatives of the classes and the recipe classes of the recipe map.
+     * Has to be called again if characters are united or recipes are registered afterwards.
+    */
+    void build();
+
+    /**
+     * @brief Gets the character representing the class of the given character.
+    */
+    CharacterId getRepresentative(CharacterId character) const {
+        return uint32_t(character) < representatives.size() ? representatives[uint32_t(character)] : character;
+    }
+    /**
+     * @brief Checks whether the two characters are variants of each other, or the same character.
+    */
+    bool areVariants(CharacterId a, CharacterId b) const { return getRepresentative(a) == getRepresentative(b); }
+    /**
+     * @brief Gets all characters of the class of the given character, including itself. Empty before build.
+    */
+    util::ArrayView<CharacterId> getVariants(CharacterId character) const { return members[uint32_t(getRepresentative(character))]; }
+
+    /**
+     * @brief Computes the class of a recipe and stores it, so it is known to getRecipeClass.
+     * Recipes of the recipe map are added by build already.
+     * @return The class, see getRecipeClass.
+    */
+    uint32_t addRecipeClass(const Recipe& recipe);
+    /**
+     * @brief Gets the class of a recipe, the canonical id of the recipe with all characters replaced by their representatives.
+     * Only reads, so it can be called from several threads as long as no recipes are interned or added meanwhile.
+     * @return The class, or 0 if no recipe of the class has been added, in which case no recipe of the recipe map is in it.
+    */
+    uint32_t getRecipeClass(const Recipe& recipe) const;
+    /**
+     * @brief Finds a recipe of the recipe map in the same class as the given recipe.
+     * @return The recipe, or nullptr if there is none.
+    */
+    const Recipe* findRecipe(const Recipe& recipe) const;
+};
+
+// The classes of the loaded characters, filled by loading::loadVariants and built by loading::loadAll.
+extern VariantClasses variantClasses;
+
+} // namespace crafting
+
+#endif // ifndef VARIANT_CLASSES_H
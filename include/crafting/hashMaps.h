@@ -3,18 +3,31 @@
 
 #include "Recipe.h"
 #include "Character.h"
+#include "CharacterTable.h"
+#include "StringPool.h"
+#include <ostream>
 
 namespace crafting {
     // A map to look up the vector with the possible result of a recipe. Almost always contains only one character.
-    extern std::unordered_map<Recipe, std::vector<std::shared_ptr<Character>>> recipeMap;
-    // A map to look up the data related to a UTF-32 character.
-    extern std::unordered_map<char32_t, std::shared_ptr<Character>> characterMap;
+    extern std::unordered_map<Recipe, std::vector<CharacterId>> recipeMap;
+    // The table holding the data related to every known UTF-32 character.
+    extern CharacterTable characterTable;
+    // The text of the meanings of all characters, each distinct meaning stored once.
+    extern util::StringPool meaningPool;
 
     /**
      * @brief Registers a recipe with the given result and recipe string.
+     * @param regions The regions the recipe is used in. Registering the same recipe again adds to its regions.
      * @return True if the recipe was successfully registered, false otherwise.
     */
-    bool registerRecipe(char32_t result, std::u32string recipeString);
+    bool registerRecipe(char32_t result, const std::u32string& recipeString, RegionMask regions = ALL_REGIONS);
+
+    /**
+     * @brief Registers an already parsed recipe with the given result.
+     * @param regions The regions the recipe is used in. Registering the same recipe again adds to its regions.
+     * @return True if the recipe was successfully registered, false otherwise.
+    */
+    bool registerRecipe(char32_t result, IdsTree recipeTree, RegionMask regions = ALL_REGIONS);
 
     /**
      * @brief Registers meanings to a given character.
@@ -33,10 +46,51 @@ namespace crafting {
     bool registerMeanings(char32_t character, std::string meanings);
 
     /**
-     * @brief Gets the character with the given UTF-32 code point from the hash map.
-     * @return A pointer to the character with the given code point.
+     * @brief Registers two characters as variants of each other, e.g. the simplified and the traditional form.
+     * Both are added to the alternatives of each other and put into the same variant class.
+     * @return True if the variants were registered, false if one of the characters is not in the character table.
+    */
+    bool registerVariants(char32_t character, char32_t variant);
+
+    /**
+     * @brief Registers the radical and stroke counts of a character, see RadicalStrokeIndex.
+     * @param radical The number of the Kangxi radical from 1 to 214.
+     * @param radicalStrokes The strokes of the radical as it is written in the character.
+     * @param residualStrokes The strokes of the character besides the radical.
+     * @return True if the data was registered, false if the character is not in the character table or already has data.
+    */
+    bool registerRadicalStrokes(char32_t character, int radical, int radicalStrokes, int residualStrokes);
+
+    /**
+     * @brief Whether the given recipe makes the given result in the given region.
+     * The recipe map holds the recipes of all regions, so its results have to be checked before crafting them.
+    */
+    bool isRecipeActive(const Recipe& recipe, CharacterId result, Region region);
+
+    /**
+     * @brief Looks up the results of a recipe in the recipe map. If the recipe is not in it, a recipe that only differs
+     * by variants of the same characters is looked up instead, see VariantClasses.
+     * @param found If not nullptr, set to the recipe of the recipe map the results belong to.
+     * @return The results, or nullptr if there is no such recipe.
+    */
+    const std::vector<CharacterId>* findRecipeResults(const Recipe& recipe, const Recipe** found = nullptr);
+
+    /**
+     * @brief Gets the character with the given UTF-32 code point from the character table, adding it if needed.
+     * @return The character with the given code point, owned by the character table.
+    */
+    Character& getCharacter(char32_t character);
+
+    /**
+     * @brief Gets the id of the character with the given UTF-32 code point, adding it to the character table if needed.
+    */
+    CharacterId getCharacterId(char32_t character);
+
+    /**
+     * @brief Prints how well the recipe map is distributed: the bucket load and how many recipes share a hash or a bucket.
+     * @param out The stream to print the report to.
     */
-    std::shared_ptr<Character> getCharacter(char32_t character);
+    void printRecipeMapReport(std::ostream& out);
 }
 
 #endif // ifndef HASH_MAPS_H
\ No newline at end of file
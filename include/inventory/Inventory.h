@@ -9,9 +9,24 @@ namespace inventory {
 class Inventory {
 private:
     // The inventory as a map that attributes an item's amount to each character in the inventory.
-    std::map<char32_t, unsigned int> items;
+    std::map<crafting::CharacterId, unsigned int> items;
+    // The total amount of the items of every variant class, by the class's representative, see crafting::VariantClasses.
+    std::map<crafting::CharacterId, unsigned int> variantCounts;
     // The maximum capacity of the inventory. Unlimited if 0.
     unsigned int capacity;
+    /**
+     * @brief Takes up to the given amount of exactly the given item.
+     * @return The amount that could not be taken.
+    */
+    unsigned int takeItem(crafting::CharacterId item, unsigned int amount);
+    /**
+     * @brief Lowers the total amount of a variant class.
+    */
+    void takeFromVariantCount(crafting::CharacterId representative, unsigned int amount);
+    /**
+     * @brief Counts how often each character is needed for the given ingredient, by the representative of its variant class.
+    */
+    static void countIngredients(const crafting::Ingredient& ingredient, std::map<crafting::CharacterId, unsigned int>& counts);
 public:
     /**
      * @brief Constructs an inventory with the given capacity.
@@ -25,14 +40,14 @@ public:
      * @param amount The amount of the item to add.
      * @return True if the item was successfully added, false otherwise.
     */
-    bool addItem(char32_t item, unsigned int amount = 1);
+    bool addItem(crafting::CharacterId item, unsigned int amount = 1);
 
     /**
-     * @brief Removes an item from the inventory.
+     * @brief Removes an item from the inventory. If there is not enough of the item itself, its variants are removed instead.
      * @param item The item to remove.
-     * @param amount The amount of the item to remove, or all if negative.
+     * @param amount The amount of the item to remove, or all of exactly this item if negative.
     */
-    void removeItem(char32_t item, int amount = -1);
+    void removeItem(crafting::CharacterId item, int amount = -1);
 
     /**
      * @brief Clears the inventory.
@@ -40,22 +55,24 @@ public:
     void clearInventory();
 
     /**
-     * @brief Checks if the inventory contains the given amount of the given item.
+     * @brief Checks if the inventory contains the given amount of the given item. Variants of the item count as the item.
      * @param item The item to check for.
      * @param amount The amount of the item to check for.
      * @return True if the player has the item, false otherwise.
     */  
-    bool hasItem(char32_t item, unsigned int amount = 1) const;
+    bool hasItem(crafting::CharacterId item, unsigned int amount = 1) const;
 
     /**
      * @brief Checks if the inventory contains the given ingredient or the components thereof.
+     * Characters used several times in the ingredient have to be in the inventory as often.
      * @param ingredient The ingredient to check for.
      * @return True if the player has the ingredient, false otherwise.
     */
     bool hasIngredients(const crafting::Ingredient& ingredient) const;
 
     /**
-     * @brief Removes the given ingredients from the inventory.
+     * @brief Removes the given ingredients from the inventory, one item for every use of a character in the ingredient.
+     * Nothing is removed if the inventory does not contain all of them.
      * @param ingredient The ingredients to remove.
      * @return True if the ingredients were successfully removed, false otherwise.
     */
@@ -65,6 +82,11 @@ public:
      * @brief Gets the total amount of items in the inventory.
     */
     unsigned int getTotalAmount() const;
+
+    /**
+     * @brief Gets the amount of every item in the inventory, without combining variants.
+    */
+    const std::map<crafting::CharacterId, unsigned int>& getItems() const { return items; }
 };
 
 } // namespace inventory
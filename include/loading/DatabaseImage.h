@@ -0,0 +1,163 @@
+#ifndef DATABASE_IMAGE_H
+#define DATABASE_IMAGE_H
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace loading {
+
+/**
+ * Layout of the binary database image. All sections are arrays of the structs below, references between them
+ * are indices into those arrays, so the image is read straight from the memory mapping without parsing.
+ *
+ * The image is a snapshot of the loaded data that is decoded into the crafting tables in a single pass, it is not used
+ * in place: recipes are polymorphic Ingredient objects, and the recipe map and character table own their entries,
+ * so they can not live in a read-only mapping without changing the whole crafting model. Decoding skips what makes
+ * loading the sources slow instead: splitting text, parsing IDS expressions and hashing every meaning of every character.
+ *
+ * [ImageHeader][CharacterRecord...][RecipeNode...][RecipeRef...][RecipeMapEntry...]
+ * [uint32_t recipe map results...][uint32_t meaning refs...][uint32_t alternatives...][uint32_t Four-Corner codes...]
+ * [uint32_t meaning offsets...][meaning bytes...]
+*/
+namespace image {
+
+// Increased whenever the layout changes, older images are then rebuilt.
+constexpr uint32_t VERSION = 4;
+constexpr char MAGIC[4] = {'K', 'C', 'D', 'B'};
+// Set in an ingredient reference if it refers to a character record instead of a recipe node.
+constexpr uint32_t CHARACTER_REF = 0x80000000;
+
+struct ImageHeader {
+    char magic[4];
+    uint32_t version;
+    // Stamp of the source files and config.h settings the image was built from, see stampDatabaseSources.
+    uint64_t sourceStamp;
+    uint32_t numCharacters;
+    uint32_t numNodes;
+    uint32_t numRecipeRefs;
+    uint32_t numRecipeMapEntries;
+    uint32_t numRecipeMapResults;
+    uint32_t numMeaningRefs;
+    uint32_t numAlternatives;
+    uint32_t numFourCornerCodes;
+    // The distinct meanings, each stored once no matter how many characters share it.
+    uint32_t numMeanings;
+    uint32_t meaningBytes;
+    // The fields of crafting::DictionaryData that were loaded.
+    uint32_t dictionaryFields;
+    uint32_t reserved;
+};
+
+struct CharacterRecord {
+    char32_t codePoint;
+    uint8_t placementFlags;
+    uint8_t glyphFlags;
+    // Dictionary data, see crafting::DictionaryData, 0 if the character has none.
+    uint16_t coreRegions;
+    uint32_t cangjie;
+    uint8_t frequency;
+    uint8_t gradeLevel;
+    // Radical and stroke counts, see crafting::RadicalStrokeIndex, radical is 0 if the character has none.
+    uint8_t radical;
+    uint8_t radicalStrokes;
+    uint8_t residualStrokes;
+    uint8_t reserved[3];
+    // Range in the recipe refs section.
+    uint32_t firstRecipe;
+    uint32_t numRecipes;
+    // Range in the meaning refs section, which holds indices of meanings.
+    uint32_t firstMeaning;
+    uint32_t numMeanings;
+    // Range in the alternatives section, which holds character indices.
+    uint32_t firstAlternative;
+    uint32_t numAlternatives;
+    // Range in the Four-Corner codes section, which holds packed codes.
+    uint32_t firstFourCornerCode;
+    uint32_t numFourCornerCodes;
+};
+
+/**
+ * A recipe node. Nodes are stored in post-order, so the ingredients of a node always precede it.
+*/
+struct RecipeNode {
+    char32_t op;
+    uint8_t approx;
+    uint8_t numIngredients;
+    uint16_t reserved;
+    // Node index, or character index combined with CHARACTER_REF.
+    uint32_t ingredients[3];
+};
+
+/**
+ * A recipe of a character, with the regions it is used in.
+*/
+struct RecipeRef {
+    uint32_t node;
+    uint16_t regions;
+    uint16_t reserved;
+};
+
+struct RecipeMapEntry {
+    uint32_t node;
+    // Range of character indices in the recipe map results section.
+    uint32_t firstResult;
+    uint32_t numResults;
+};
+
+} // namespace image
+
+/**
+ * @brief A read-only view of a memory-mapped database image.
+*/
+class DatabaseImage {
+private:
+    util::MappedFile file;
+    const image::ImageHeader* mHeader = nullptr;
+    const image::CharacterRecord* mCharacters = nullptr;
+    const image::RecipeNode* mNodes = nullptr;
+    const image::RecipeRef* mRecipeRefs = nullptr;
+    const image::RecipeMapEntry* mRecipeMapEntries = nullptr;
+    const uint32_t* mRecipeMapResults = nullptr;
+    const uint32_t* mMeaningRefs = nullptr;
+    const uint32_t* mAlternatives = nullptr;
+    const uint32_t* mFourCornerCodes = nullptr;
+    const uint32_t* mMeaningOffsets = nullptr;
+    const char* mMeaningBytes = nullptr;
+public:
+    /**
+     * @brief Maps the image at the given path and checks that it is complete and was built from the given sources.
+     * @param path The path of the image file.
+     * @param expectedStamp The stamp of the current source files, see stampDatabaseSources.
+     * @return True if the image can be used, false if it does not exist, is outdated or is malformed.
+    */
+    bool open(const std::string& path, uint64_t expectedStamp);
+
+    const image::ImageHeader& header() const { return *mHeader; }
+    const image::CharacterRecord* characters() const { return mCharacters; }
+    const image::RecipeNode* nodes() const { return mNodes; }
+    const image::RecipeRef* recipeRefs() const { return mRecipeRefs; }
+    const image::RecipeMapEntry* recipeMapEntries() const { return mRecipeMapEntries; }
+    const uint32_t* recipeMapResults() const { return mRecipeMapResults; }
+    const uint32_t* meaningRefs() const { return mMeaningRefs; }
+    const uint32_t* alternatives() const { return mAlternatives; }
+    const uint32_t* fourCornerCodes() const { return mFourCornerCodes; }
+    /**
+     * @brief Gets a meaning as a view into the mapped image.
+     * @param index The index of the meaning in the meaning offsets section.
+    */
+    std::string_view meaning(uint32_t index) const {
+        return std::string_view(mMeaningBytes + mMeaningOffsets[index], mMeaningOffsets[index + 1] - mMeaningOffsets[index]);
+    }
+};
+
+/**
+ * @brief Combines the sizes and modification times of all files the database is loaded from with the relevant config.h settings.
+ * Only the file metadata is read, so checking whether an image is up to date is cheap.
+*/
+extern uint64_t stampDatabaseSources();
+
+} // namespace loading
+
+#endif // DATABASE_IMAGE_H
@@ -0,0 +1,70 @@
+#ifndef DATABASE_REPORT_H
+#define DATABASE_REPORT_H
+
+#include "loading.h"
+#include "CharacterId.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace loading {
+
+/**
+ * @brief The problems found in the IDS files and the loaded characters and recipes, see validateDatabase.
+*/
+struct DatabaseReport {
+    /**
+     * @brief A character that can not be rendered from its recipe.
+    */
+    struct BrokenRender {
+        crafting::CharacterId character;
+        // The character the rendering fails at, either an unrenderable one or one on a cycle.
+        crafting::CharacterId component;
+        bool cycle;
+    };
+    /**
+     * @brief A recipe listed more than once for the same character.
+    */
+    struct DuplicateRecipe {
+        crafting::CharacterId character;
+        uint32_t recipe;
+        uint32_t duplicateOf;
+    };
+
+    // Invalid lines and recipes in the IDS files, e.g. recipes with too many or too few ingredients for their operators.
+    std::vector<RecipeError> recipeErrors;
+    // Groups of characters whose recipes lead back to each other, ordered by their first character.
+    std::vector<std::vector<crafting::CharacterId>> cycles;
+    // Characters that are in none of the font faces and have no recipes, rendering them throws.
+    std::vector<crafting::CharacterId> unrenderable;
+    // Characters rendered from their first recipe where the rendering throws or never ends.
+    std::vector<BrokenRender> brokenRenders;
+    std::vector<DuplicateRecipe> duplicateRecipes;
+    // Indices into the component index of the recipes that make more than one character.
+    std::vector<uint32_t> sharedRecipes;
+
+    /**
+     * @brief Gets the number of problems found, not counting shared recipes, which are allowed.
+    */
+    size_t numProblems() const {
+        return recipeErrors.size() + cycles.size() + unrenderable.size() + brokenRenders.size() + duplicateRecipes.size();
+    }
+
+    /**
+     * @brief Writes the report as a JSON object.
+    */
+    void writeJson(std::ostream& out) const;
+};
+
+/**
+ * @brief Checks the whole database on several threads: the recipes of the IDS files and the loaded characters and recipes.
+ * The recipes, font faces and component index have to be loaded, see loadAll.
+ * @param idsPaths The IDS files to check the recipes of.
+ * @param threads The number of threads to use, or 0 to use one per hardware thread.
+*/
+extern DatabaseReport validateDatabase(const std::vector<std::string>& idsPaths, unsigned int threads = 0);
+
+} // namespace loading
+
+#endif // DATABASE_REPORT_H
@@ -1,7 +1,9 @@
 #ifndef LOADING_H
 #define LOADING_H
 
+#include "DictionaryData.h"
 #include <string>
+#include <vector>
 
 namespace loading {
 
@@ -17,11 +19,85 @@ extern void loadRecipes();
 */
 extern void loadRecipes(std::string path);
 
+/**
+ * @brief Loads the recipes from a given IDS file by memory-mapping it and tokenizing it in place, without copying lines or columns.
+ * @throws std::runtime_error if the IDS file could not be opened or if the file is invalid.
+*/
+extern void loadRecipesMapped(std::string path);
+
+/**
+ * @brief Loads the recipes from a given IDS file by memory-mapping it and parsing chunks of it on several threads.
+ * The recipes are registered in file order afterwards, so the result is identical to loadRecipesMapped.
+ * @param threads The number of threads to use, or 0 to use one per hardware thread.
+ * @throws std::runtime_error if the IDS file could not be opened or if the file is invalid.
+*/
+extern void loadRecipesParallel(std::string path, unsigned int threads = 0);
+
+/**
+ * @brief An invalid line or recipe in an IDS file.
+*/
+struct RecipeError {
+    std::string path;
+    int lineNum;
+    // The character the recipe is for, 0 if the line itself is invalid.
+    char32_t character;
+    std::u32string recipe;
+    std::string message;
+};
+
+/**
+ * @brief Checks every recipe of a given IDS file that would be loaded, on several threads, without registering them.
+ * Unlike loading, it does not stop at the first invalid recipe.
+ * @param threads The number of threads to use, or 0 to use one per hardware thread.
+ * @return The invalid lines and recipes in file order, e.g. recipes with too many or too few ingredients for their operators.
+ * @throws std::runtime_error if the IDS file could not be opened.
+*/
+extern std::vector<RecipeError> findRecipeErrors(std::string path, unsigned int threads = 0);
+
 /**
  * @brief Loads the meanings from the unihan readings file.
 */
 extern void loadMeanings();
 
+/**
+ * @brief Reads only where the meanings of every character are in the unihan readings file, see crafting::LazyMeanings.
+ * The meanings themselves are loaded when they are first needed.
+ * @throws std::runtime_error if the readings file could not be opened.
+*/
+extern void loadMeaningsLazily();
+
+/**
+ * @brief Reads only where the meanings of every character are in a given readings file, see crafting::LazyMeanings.
+ * @throws std::runtime_error if the readings file could not be opened.
+*/
+extern void loadMeaningsLazily(std::string path);
+
+/**
+ * @brief Loads the links between variants of the same character from the unihan variants file,
+ * see crafting::registerVariants. Only characters that are already loaded are linked.
+*/
+extern void loadVariants();
+
+/**
+ * @brief Loads the given fields of the unihan dictionary like data file into crafting::dictionaryData, in a single pass
+ * over the memory-mapped file. Only characters that are already loaded get them.
+ * @param fields The fields to load, see crafting::DictionaryField.
+ * @throws std::runtime_error if the dictionary like data file could not be opened.
+*/
+extern void loadDictionaryData(crafting::DictionaryFieldMask fields = crafting::ALL_DICTIONARY_FIELDS);
+
+/**
+ * @brief Loads the given fields of a given dictionary like data file into crafting::dictionaryData.
+ * @throws std::runtime_error if the dictionary like data file could not be opened.
+*/
+extern void loadDictionaryData(std::string path, crafting::DictionaryFieldMask fields = crafting::ALL_DICTIONARY_FIELDS);
+
+/**
+ * @brief Loads the radicals and stroke counts of the characters from the unihan radical stroke counts file,
+ * see crafting::registerRadicalStrokes. Only characters that are already loaded get them.
+*/
+extern void loadRadicalStrokeCounts();
+
 /**
  * @brief Loads hardcoded flags for some characters.
 */
@@ -33,7 +109,25 @@ extern void loadCharacterFlags();
 extern void loadFreeType();
 
 /**
- * @brief Loads all the data.
+ * @brief Loads characters, recipes, meanings, character flags, variants, dictionary data and radical stroke counts from a binary database image.
+ * The image is decoded into the same tables loading the sources fills, it is closed again afterwards.
+ * The indices over them are not built.
+ * @param path The path of the image, as written by writeDatabaseImage.
+ * @return True if the image was loaded, false if it does not exist or is outdated because the source files or config.h settings changed.
+*/
+extern bool loadDatabaseImage(const std::string& path);
+
+/**
+ * @brief Writes the currently loaded characters, recipes, meanings, character flags, variants, dictionary data and radical stroke counts
+ * to a binary database image.
+ * @param path The path to write the image to.
+ * @return True if the image was successfully written, false otherwise.
+*/
+extern bool writeDatabaseImage(const std::string& path);
+
+/**
+ * @brief Loads all the data. Uses the database image if it is up to date, otherwise the source files are loaded and the image is rebuilt.
+ * Builds the indices over the loaded data afterwards.
 */
 extern void loadAll();
 
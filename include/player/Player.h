@@ -4,7 +4,11 @@
 
 #include "Character.h"
 #include "Recipe.h"
+#include "Region.h"
 #include "Inventory.h"
+#include "CraftingPlanner.h"
+#include "DecompositionTable.h"
+#include "RecipeMatcher.h"
 #include "Modifier.h"
 #include <memory>
 #include <map>
@@ -25,6 +29,10 @@ private:
     unsigned int mInk;
     // The player's inventory.
     inventory::Inventory inventory;
+    // The region whose recipes the player crafts with.
+    crafting::Region region;
+    // Plans crafts from the player's inventory, keeps its costs between plans.
+    crafting::CraftingPlanner planner;
     // The player's modifiers.
     std::vector<Modifier> modifiers;
     /**
@@ -82,6 +90,11 @@ public:
     */
     inventory::Inventory& getInventory() { return inventory; }
 
+    /**
+     * @brief Gets the region whose recipes the player crafts with. Initially crafting::getDefaultRegion.
+    */
+    crafting::Region getRegion() const { return region; }
+
     /**
      * @brief Sets the player's health.
      * @param health The player's new health.
@@ -100,6 +113,12 @@ public:
     */
     void setInk(unsigned int ink) { mInk = ink; }
 
+    /**
+     * @brief Switches the recipes the player crafts with to those of another region.
+     * All regions are kept loaded, so this only changes which of them count, see crafting::Character::isRecipeActive.
+    */
+    void setRegion(crafting::Region region) { this->region = region; }
+
     /**
      * @brief Changes the player's health by the given amount.
     */
@@ -140,12 +159,32 @@ public:
 
     /**
      * @brief Crafts the given recipe from the items in the player's inventory, if available.
+     * Variants of the characters in the recipe count as the same characters, see crafting::findRecipeResults.
      * @param recipe The recipe to craft.
      * @param variation The index of the item to craft, if the recipe has multiple possible results.
-     * @return True if the recipe was successfully crafted, false otherwise.
+     * @return True if the recipe was successfully crafted, false otherwise, also if the result is only made
+     * by the recipe in another region than the player's, see setRegion.
     */
     bool craft(const crafting::Recipe& recipe, unsigned int variation = 0);
 
+    /**
+     * @brief Plans the cheapest way of crafting the given character from the items in the player's inventory.
+     * @param target The character to craft.
+     * @param steps Set to the crafts to do in order, see craft.
+     * @return True if the character can be crafted, false otherwise.
+    */
+    bool planCraft(crafting::CharacterId target, std::vector<crafting::CraftStep>& steps);
+
+    /**
+     * @brief Starts matching an ingredient the player builds against the recipes of the player's region.
+    */
+    crafting::RecipeMatcher::Cursor startMatching() const { return crafting::recipeMatcher.start(region); }
+
+    /**
+     * @brief Gets the decompositions of the characters along the recipes of the player's region.
+    */
+    const crafting::DecompositionTable& getDecompositions() const { return crafting::decompositionTables.get(region); }
+
 };
 
 } // namespace player
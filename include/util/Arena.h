@@ -0,0 +1,78 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief A bump allocator for objects of one type. Objects are placed one after another in large blocks,
+ * so they never move, objects created together lie next to each other in memory,
+ * and all of them are freed at once when the arena is cleared or destroyed.
+*/
+template <typename T>
+class Arena {
+private:
+    // Uninitialized storage for the objects of one block.
+    struct Slot {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    // The number of objects in the last block.
+    size_t used;
+    size_t blockSize;
+public:
+    /**
+     * @brief Constructs an empty arena.
+     * @param blockSize The number of objects per block.
+    */
+    explicit Arena(size_t blockSize = 4096) : used(blockSize), blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() { clear(); }
+
+    /**
+     * @brief Constructs a new object in the arena.
+     * @return A pointer to the object, valid until the arena is cleared.
+    */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if(used == blockSize) {
+            blocks.push_back(std::make_unique<Slot[]>(blockSize));
+            used = 0;
+        }
+        T* object = new(blocks.back()[used].bytes) T(std::forward<Args>(args)...);
+        used++;
+        return object;
+    }
+
+    /**
+     * @brief Destroys all objects and frees the memory of the arena.
+    */
+    void clear() {
+        if(!std::is_trivially_destructible<T>::value) {
+            for(size_t i = 0; i < blocks.size(); i++) {
+                size_t count = (i + 1 == blocks.size()) ? used : blockSize;
+                for(size_t j = 0; j < count; j++) {
+                    reinterpret_cast<T*>(blocks[i][j].bytes)->~T();
+                }
+            }
+        }
+        blocks.clear();
+        used = blockSize;
+    }
+
+    /**
+     * @brief Gets the number of objects in the arena.
+    */
+    size_t size() const { return blocks.empty() ? 0 : (blocks.size() - 1) * blockSize + used; }
+};
+
+} // namespace util
+
+#endif // ARENA_H
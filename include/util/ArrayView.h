@@ -0,0 +1,32 @@
+#ifndef ARRAY_VIEW_H
+#define ARRAY_VIEW_H
+
+#include <cstddef>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief A read-only view of a contiguous range of elements that are owned by someone else.
+*/
+template <typename T>
+class ArrayView {
+private:
+    const T* mData;
+    size_t mSize;
+public:
+    ArrayView() : mData(nullptr), mSize(0) {}
+    ArrayView(const T* data, size_t size) : mData(data), mSize(size) {}
+    ArrayView(const std::vector<T>& vector) : mData(vector.data()), mSize(vector.size()) {}
+
+    const T* begin() const { return mData; }
+    const T* end() const { return mData + mSize; }
+    const T* data() const { return mData; }
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    const T& operator[](size_t index) const { return mData[index]; }
+};
+
+} // namespace util
+
+#endif // ARRAY_VIEW_H
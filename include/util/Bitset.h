@@ -0,0 +1,80 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief A set of indices in [0, size) stored as one bit per index.
+*/
+class Bitset {
+private:
+    std::vector<uint64_t> words;
+    size_t mSize = 0;
+public:
+    Bitset() = default;
+    explicit Bitset(size_t size) { resize(size); }
+
+    /**
+     * @brief Changes the number of indices. Added indices are not in the set.
+    */
+    void resize(size_t size) {
+        words.resize((size + 63) / 64, 0);
+        mSize = size;
+    }
+    /**
+     * @brief Removes all indices from the set.
+    */
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+
+    void set(size_t index) { words[index / 64] |= uint64_t(1) << (index % 64); }
+    void reset(size_t index) { words[index / 64] &= ~(uint64_t(1) << (index % 64)); }
+    bool test(size_t index) const { return (words[index / 64] >> (index % 64)) & 1; }
+    /**
+     * @brief Adds the index to the set.
+     * @return True if it was not in the set before.
+    */
+    bool insert(size_t index) {
+        uint64_t mask = uint64_t(1) << (index % 64);
+        bool inserted = !(words[index / 64] & mask);
+        words[index / 64] |= mask;
+        return inserted;
+    }
+
+    /**
+     * @brief Gets the number of indices in the set.
+    */
+    size_t count() const {
+        size_t result = 0;
+        for(uint64_t word : words) {
+            result += __builtin_popcountll(word);
+        }
+        return result;
+    }
+    /**
+     * @brief Gets the number of possible indices.
+    */
+    size_t size() const { return mSize; }
+
+    /**
+     * @brief Calls a function with every index in the set, in ascending order.
+    */
+    template <typename Function>
+    void forEach(Function function) const {
+        for(size_t i = 0; i < words.size(); i++) {
+            uint64_t word = words[i];
+            while(word) {
+                function(i * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+} // namespace util
+
+#endif // BITSET_H
@@ -0,0 +1,65 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace util {
+
+/**
+ * @brief A read-only memory mapping of a whole file. The mapping is released when the object is destroyed.
+*/
+class MappedFile {
+private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+    #ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+    #endif
+public:
+    MappedFile() = default;
+    /**
+     * @brief Maps the file at the given path. Check with operator bool whether the mapping succeeded.
+    */
+    MappedFile(const std::string& path) { open(path); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile() { close(); }
+
+    /**
+     * @brief Maps the file at the given path, releasing any previous mapping.
+     * @return True if the file was successfully mapped, false otherwise.
+    */
+    bool open(const std::string& path);
+    /**
+     * @brief Releases the mapping.
+    */
+    void close();
+
+    /**
+     * @brief Whether a file is currently mapped. Empty files count as mapped.
+    */
+    bool isOpen() const { return mData != nullptr; }
+    operator bool() const { return isOpen(); }
+
+    /**
+     * @brief Gets a pointer to the first byte of the mapped file.
+    */
+    const char* data() const { return mData; }
+    /**
+     * @brief Gets the size of the mapped file in bytes.
+    */
+    size_t size() const { return mSize; }
+    /**
+     * @brief Gets a view over the whole content of the mapped file.
+    */
+    std::string_view view() const { return std::string_view(mData, mSize); }
+};
+
+} // namespace util
+
+#endif // MAPPED_FILE_H
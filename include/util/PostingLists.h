@@ -0,0 +1,72 @@
+#ifndef POSTING_LISTS_H
+#define POSTING_LISTS_H
+
+#include "ArrayView.h"
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief A list of values for every key in [0, numKeys), stored together in one array (compressed sparse rows).
+ *
+ * Built in two passes over the data: first count() is called for every value, then allocate(),
+ * then add() for every value. The lists can be read once all counted values were added.
+*/
+template <typename T>
+class PostingLists {
+private:
+    // offsets[key] to offsets[key + 1] is the range of the key in values.
+    std::vector<uint32_t> offsets{0};
+    std::vector<T> values;
+public:
+    /**
+     * @brief Clears all lists and starts counting for the given number of keys.
+    */
+    void reset(size_t numKeys) {
+        offsets.assign(numKeys + 1, 0);
+        values.clear();
+    }
+    /**
+     * @brief Counts values that will be added to the list of a key.
+    */
+    void count(size_t key, uint32_t amount = 1) { offsets[key + 1] += amount; }
+    /**
+     * @brief Allocates the counted values.
+    */
+    void allocate() {
+        for(size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+        values.resize(offsets.back());
+        // shifted by one key, so add() can advance offsets[key + 1] from the start to the end of the key's range
+        for(size_t i = offsets.size() - 1; i > 0; i--) {
+            offsets[i] = offsets[i - 1];
+        }
+    }
+    /**
+     * @brief Adds a value to the list of a key. Must not be called more often for a key than it was counted.
+    */
+    void add(size_t key, const T& value) { values[offsets[key + 1]++] = value; }
+    /**
+     * @brief Gets the list of a key, or an empty list if the key is out of range.
+    */
+    ArrayView<T> operator[](size_t key) const {
+        if(key + 1 >= offsets.size()) {
+            return ArrayView<T>();
+        }
+        return ArrayView<T>(values.data() + offsets[key], offsets[key + 1] - offsets[key]);
+    }
+    /**
+     * @brief Gets the number of keys.
+    */
+    size_t numKeys() const { return offsets.size() - 1; }
+    /**
+     * @brief Gets the total number of values in all lists.
+    */
+    size_t size() const { return values.size(); }
+};
+
+} // namespace util
+
+#endif // POSTING_LISTS_H
@@ -0,0 +1,107 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief Stores immutable strings without duplicates. The characters of the strings are placed one after another
+ * in large blocks, so they never move and views of them stay valid until the pool is cleared or destroyed.
+ * Every distinct string gets a 32-bit id in the order it was first added.
+ *
+ * Finding duplicates needs an index of all strings, which can be freed with freeze once no more strings are added.
+ * The blocks can hold at most 2 GiB in total.
+*/
+class StringPool {
+private:
+    /**
+     * @brief Where a string is stored. Strings that fit into a block are at blockSize * block + position in blocks,
+     * longer ones have LARGE_BIT set and the index in largeStrings as start.
+    */
+    struct Location {
+        uint32_t start;
+        uint32_t length;
+    };
+    static constexpr uint32_t LARGE_BIT = 0x80000000;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    // Strings longer than a block, each stored on its own.
+    std::vector<std::unique_ptr<char[]>> largeStrings;
+    // The number of bytes used in the last block.
+    size_t used;
+    size_t blockSize;
+    // The location of every string by id.
+    std::vector<Location> locations;
+    // Open addressing hash table of the ids plus one, 0 for empty slots. Its size is a power of two, or 0 if frozen.
+    std::vector<uint32_t> index;
+    size_t numBytes = 0;
+
+    /**
+     * @brief Copies the string into the blocks.
+     * @return The location of the copy.
+    */
+    Location store(std::string_view string);
+    /**
+     * @brief Gets the slot of the index holding the given string, or the empty slot it would be put into.
+    */
+    uint32_t& findSlot(std::string_view string);
+    /**
+     * @brief Rebuilds the index with the given number of slots.
+    */
+    void rehash(size_t numSlots);
+public:
+    /**
+     * @brief Constructs an empty pool.
+     * @param blockSize The number of bytes per block. Longer strings get a block of their own.
+    */
+    explicit StringPool(size_t blockSize = 65536) : used(blockSize), blockSize(blockSize) {}
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief Adds a string to the pool if an equal one is not in it yet. Rebuilds the index first if the pool was frozen.
+     * @return The id of the string.
+    */
+    uint32_t intern(std::string_view string);
+    /**
+     * @brief Gets a view of the pooled string with the given id.
+    */
+    std::string_view operator[](uint32_t id) const {
+        Location location = locations[id];
+        if(location.start & LARGE_BIT) {
+            return std::string_view(largeStrings[location.start & ~LARGE_BIT].get(), location.length);
+        }
+        return std::string_view(blocks[location.start / blockSize].get() + location.start % blockSize, location.length);
+    }
+
+    /**
+     * @brief Frees the index used to find duplicates and any spare capacity, once all strings have been added.
+     * Adding a string afterwards rebuilds the index.
+    */
+    void freeze();
+    /**
+     * @brief Whether the index is freed, see freeze.
+    */
+    bool isFrozen() const { return index.empty(); }
+    /**
+     * @brief Frees all strings. All views of them become invalid.
+    */
+    void clear();
+
+    /**
+     * @brief Gets the number of distinct strings in the pool.
+    */
+    size_t size() const { return locations.size(); }
+    /**
+     * @brief Gets the total length of the distinct strings in the pool.
+    */
+    size_t bytes() const { return numBytes; }
+};
+
+} // namespace util
+
+#endif // STRING_POOL_H
@@ -1,12 +1,30 @@
-
 #ifndef BYTE_UTIL_H
 #define BYTE_UTIL_H
 
 #include <stdint.h>
+#include <string_view>
 
 namespace util {
     
 extern void setBit(uint8_t* byte, int idx, bool value);
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of the given bytes.
+ * @param bytes The bytes to hash.
+ * @param hash The hash to continue from, so that several byte sequences can be hashed as one.
+*/
+extern uint64_t fnv1a(std::string_view bytes, uint64_t hash = 14695981039346656037ull);
+
+/**
+ * @brief Mixes a value into a hash, so that the order of combined values matters.
+*/
+inline uint64_t hashCombine(uint64_t hash, uint64_t value) {
+    // finalizer of splitmix64, applied to the sum of both
+    uint64_t x = hash * 0x9E3779B97F4A7C15ull + value + 0x632BE59BD9B4E019ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
 	
 }
 
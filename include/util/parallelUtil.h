@@ -0,0 +1,27 @@
+#ifndef PARALLEL_UTIL_H
+#define PARALLEL_UTIL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace util {
+
+/**
+ * @brief Gets the number of threads to use for a given setting.
+ * @param requested The requested number of threads, or 0 to use one per hardware thread.
+*/
+extern unsigned int threadCount(unsigned int requested = 0);
+
+/**
+ * @brief Runs a task for every index in [0, count) on a pool of worker threads and waits until all of them are done.
+ * Indices are handed out dynamically, so tasks of uneven length are balanced between the threads.
+ * If a task throws, the remaining indices are skipped and the first exception is rethrown on the calling thread.
+ * @param count The number of indices.
+ * @param task The task to run, called with the index and the number of the worker thread running it.
+ * @param threads The number of threads to use, or 0 to use one per hardware thread.
+*/
+extern void parallelFor(size_t count, const std::function<void(size_t index, unsigned int worker)>& task, unsigned int threads = 0);
+
+} // namespace util
+
+#endif // PARALLEL_UTIL_H
@@ -3,6 +3,7 @@
 
 #include <codecvt>
 #include <locale>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -18,6 +19,26 @@ extern std::string u32_to_u8(const std::u32string& str);
 */
 extern std::u32string u8_to_u32(const std::string& str);
 
+/**
+ * @brief Decodes the UTF-8 encoded code point starting at the given position.
+ * @param str The UTF-8 encoded string.
+ * @param pos The byte position to start decoding at. Advanced past the decoded code point.
+ * @return The decoded code point, or U+FFFD if the sequence is invalid or truncated.
+*/
+extern char32_t decodeUtf8(std::string_view str, size_t& pos);
+
+/**
+ * @brief Decodes a UTF-8 string into an existing UTF-32 buffer without allocating a new string.
+ * @param str The UTF-8 encoded string.
+ * @param out The buffer to decode into. Its previous content is replaced, but its capacity is reused.
+*/
+extern void u8_to_u32(std::string_view str, std::u32string& out);
+
+/**
+ * @brief Counts the code points in a UTF-8 string without decoding it.
+*/
+extern size_t u8_length(std::string_view str);
+
 /**
  * @brief Converts a Unicode code point to the character it represents.
  * @param unicode The Unicode code point in the format U+<hex>.
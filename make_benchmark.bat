@@ -0,0 +1 @@
+g++ -O2 benchmark.cpp src/rendering/*.cpp src/crafting/*.cpp src/loading/*.cpp src/inventory/*.cpp src/util/*.cpp src/player/*.cpp -I external/stb -I C:/Strawberry/c/lib/pkgconfig/../../include/freetype2 -I include -I include/crafting -I include/player -I include/loading -I include/inventory -I include/util -I include/items -I include/rendering -I include/ui -I include/geometry -I . -o benchmark.exe -lfreetype
\ No newline at end of file
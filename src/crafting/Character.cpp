@@ -1,17 +1,116 @@
 #include "Character.h"
 #include "byteUtil.h"
 #include "hashMaps.h"
+#include "CharacterTable.h"
+#include "RecipeInterner.h"
+#include "LazyMeanings.h"
 
 namespace crafting {
 
-Character::Character(char32_t character) : mCharacter(character) {}
+// Values of CharacterData::fontFace.
+static constexpr uint8_t FONT_FACE_UNKNOWN = 0;
+static constexpr uint8_t FONT_FACE_MAIN = 1;
+static constexpr uint8_t FONT_FACE_BACK_UP_1 = 2;
+static constexpr uint8_t FONT_FACE_BACK_UP_2 = 3;
+static constexpr uint8_t FONT_FACE_NONE = 255;
+
+// Returned for characters that have no details in the character table.
+static const CharacterDetails noDetails;
+
+Character::Character(char32_t character) 
+    : Ingredient(IngredientKind::CHARACTER)
+    , mId(characterTable.getId(character))
+{ }
+
+CharacterData& Character::data() const {
+    return characterTable.data(mId);
+}
+
+char32_t Character::getCharacter() const {
+    return data().codePoint;
+}
+
+std::vector<std::string_view> Character::getMeanings() const {
+    // while meanings are loaded lazily, other threads may be adding to the pool, so it is read under the lock
+    std::unique_lock<std::mutex> lock = lazyMeanings.load(mId);
+    std::vector<std::string_view> meanings;
+    if(const CharacterDetails* details = characterTable.findDetails(mId)) {
+        meanings.reserve(details->meanings.size());
+        for(uint32_t meaning : details->meanings) {
+            meanings.push_back(meaningPool[meaning]);
+        }
+    }
+    return meanings;
+}
+
+const std::vector<Recipe>& Character::getRecipes() const {
+    const CharacterDetails* details = characterTable.findDetails(mId);
+    return details ? details->recipes : noDetails.recipes;
+}
+
+RegionMask Character::getRecipeRegions(size_t index) const {
+    return characterTable.findDetails(mId)->recipeRegions[index];
+}
+
+bool Character::isRecipeActive(const Recipe& recipe, Region region) const {
+    const std::vector<Recipe>& recipes = getRecipes();
+    for(size_t i = 0; i < recipes.size(); i++) {
+        if(recipes[i] == recipe) {
+            return isRecipeActive(i, region);
+        }
+    }
+    return false;
+}
+
+const Recipe* Character::getActiveRecipe(Region region) const {
+    const std::vector<Recipe>& recipes = getRecipes();
+    for(size_t i = 0; i < recipes.size(); i++) {
+        if(isRecipeActive(i, region)) {
+            return &recipes[i];
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<char32_t>& Character::getAlternatives() const {
+    const CharacterDetails* details = characterTable.findDetails(mId);
+    return details ? details->alternatives : noDetails.alternatives;
+}
+
+const std::vector<std::unique_ptr<items::Functionality>>& Character::getFunctionalities() const {
+    const CharacterDetails* details = characterTable.findDetails(mId);
+    return details ? details->functionalities : noDetails.functionalities;
+}
+
+void Character::addMeaning(std::string_view meaning) {
+    characterTable.details(mId).meanings.push_back(meaningPool.intern(meaning));
+}
+
+void Character::addRecipe(const Recipe& recipe, RegionMask regions) {
+    CharacterDetails& details = characterTable.details(mId);
+    for(size_t i = 0; i < details.recipes.size(); i++) {
+        if(details.recipes[i] == recipe) {
+            details.recipeRegions[i] |= regions;
+            return;
+        }
+    }
+    details.recipes.push_back(recipe);
+    details.recipeRegions.push_back(regions);
+}
+
+void Character::addAlternative(char32_t alternative) {
+    characterTable.details(mId).alternatives.push_back(alternative);
+}
+
+void Character::addFunctionality(std::unique_ptr<items::Functionality> functionality) {
+    characterTable.details(mId).functionalities.push_back(std::move(functionality));
+}
 
 bool Character::operator==(const Ingredient& other) const {
-    const Character* otherCharacter = dynamic_cast<const Character*>(&other);
-    if(otherCharacter == nullptr) {
+    if(other.getKind() != IngredientKind::CHARACTER) {
         return false;
     }
-    else if(mCharacter == otherCharacter->getCharacter()) {
+    else if(mId == static_cast<const Character&>(other).getId()) {
         return true;
     }
     else {
@@ -20,7 +119,7 @@ bool Character::operator==(const Ingredient& other) const {
 }
 
 bool Character::operator==(const Character& other) const {
-    if(mCharacter == other.getCharacter()) {
+    if(mId == other.getId()) {
         return true;
     }
     else {
@@ -29,10 +128,11 @@ bool Character::operator==(const Character& other) const {
 }
 
 Character::operator std::u32string() const {
-    return std::u32string(1, mCharacter);
+    return std::u32string(1, getCharacter());
 }
 
 bool Character::canBePlacedLike(char32_t character) const {
+    uint8_t placementFlags = data().placementFlags;
     switch(character) {
         case U'⿸': return placementFlags & 1;
         case U'⿹': return placementFlags & 2;
@@ -46,6 +146,7 @@ bool Character::canBePlacedLike(char32_t character) const {
 }
 
 void Character::setPlacementFlag(char32_t character, bool value) {
+    uint8_t& placementFlags = data().placementFlags;
     switch(character) {
         case U'⿸': util::setBit(&placementFlags, 0, value); return;
         case U'⿹': util::setBit(&placementFlags, 1, value); return;
@@ -58,72 +159,85 @@ void Character::setPlacementFlag(char32_t character, bool value) {
     }
 }
 
-rendering::GreyBitmap Character::render(int width, int height) const {
+uint8_t Character::lookUpFontFace() const {
+    char32_t character = getCharacter();
+    uint8_t& fontFaceIndex = data().fontFace;
+    if(fontFaceIndex == FONT_FACE_UNKNOWN) {
+        // looked up once, the font faces are not changed after loading
+        if(FT_Get_Char_Index(rendering::fontFaceMain, character) != 0) {
+            fontFaceIndex = FONT_FACE_MAIN;
+        }
+        else if(FT_Get_Char_Index(rendering::fontFaceBackUp1, character) != 0) {
+            fontFaceIndex = FONT_FACE_BACK_UP_1;
+        }
+        else if(FT_Get_Char_Index(rendering::fontFaceBackUp2, character) != 0) {
+            fontFaceIndex = FONT_FACE_BACK_UP_2;
+        }
+        else {
+            fontFaceIndex = FONT_FACE_NONE;
+        }
+    }
+    return fontFaceIndex;
+}
+
+bool Character::isInFontFaces() const {
+    return lookUpFontFace() != FONT_FACE_NONE;
+}
+
+rendering::GreyBitmap Character::render(int width, int height, Region region) const {
+    char32_t character = getCharacter();
     FT_Face fontFace;
-    if(FT_Get_Char_Index(rendering::fontFaceMain, mCharacter) != 0) {
-        fontFace = rendering::fontFaceMain;
-    }
-    else if(FT_Get_Char_Index(rendering::fontFaceBackUp1, mCharacter) != 0) {
-        fontFace = rendering::fontFaceBackUp1;
-    }
-    else if(FT_Get_Char_Index(rendering::fontFaceBackUp2, mCharacter) != 0) {
-        fontFace = rendering::fontFaceBackUp2;
-    }
-    else if(!recipes.empty()) {
-        // If the character is not in any of the font faces, use the first recipe to render it.
-        return recipes[0].render(width, height);
-    }
-    else {
-        throw std::runtime_error("Character " + std::to_string(mCharacter) + " can not be rendered because it is not in any of the font faces and has no recipes.");
+    switch(lookUpFontFace()) {
+        case FONT_FACE_MAIN: fontFace = rendering::fontFaceMain; break;
+        case FONT_FACE_BACK_UP_1: fontFace = rendering::fontFaceBackUp1; break;
+        case FONT_FACE_BACK_UP_2: fontFace = rendering::fontFaceBackUp2; break;
+        default:
+            if(const Recipe* recipe = getActiveRecipe(region)) {
+                // If the character is not in any of the font faces, use the first recipe of the region to render it.
+                return recipe->render(width, height, region);
+            }
+            throw std::runtime_error("Character " + std::to_string(character) + " can not be rendered because it is not in any of the font faces and has no recipes.");
     }
     
     if(FT_Set_Pixel_Sizes(fontFace, width, height)) {
         throw std::runtime_error("Failed to set pixel sizes for font face.");
     }
-    if(FT_Load_Char(fontFace, mCharacter, FT_LOAD_RENDER)) {
-        throw std::runtime_error("(1) Failed to load character " + std::to_string(mCharacter));
+    if(FT_Load_Char(fontFace, character, FT_LOAD_RENDER)) {
+        throw std::runtime_error("(1) Failed to load character " + std::to_string(character));
     }
     FT_Bitmap bitmap;
     if(fontFace->glyph->bitmap.width != 0) {
         bitmap = fontFace->glyph->bitmap;
     }
     else {
-        throw std::runtime_error("(2) Failed to load character " + std::to_string(mCharacter));
+        throw std::runtime_error("(2) Failed to load character " + std::to_string(character));
     }
     return rendering::GreyBitmap(bitmap).placeOnCanvas(width, height);
 }
 
-std::shared_ptr<Ingredient> Character::addLeft(std::shared_ptr<Character> character) {
-    return std::make_shared<Recipe>(U'⿰', 
-                                    std::vector<std::shared_ptr<Ingredient>>{
-                                        std::dynamic_pointer_cast<Ingredient>(character), 
-                                        std::dynamic_pointer_cast<Ingredient>(crafting::getCharacter(this->getCharacter()))});
+const Ingredient* Character::addLeft(CharacterId character) const {
+    const Ingredient* ingredients[] = {&characterTable[character], &characterTable[mId]};
+    return recipeInterner.intern(U'⿰', ingredients);
 }
 
-std::shared_ptr<Ingredient> Character::addRight(std::shared_ptr<Character> character) {
-    return std::make_shared<Recipe>(U'⿰', 
-                                    std::vector<std::shared_ptr<Ingredient>>{
-                                        std::dynamic_pointer_cast<Ingredient>(crafting::getCharacter(this->getCharacter())), 
-                                        std::dynamic_pointer_cast<Ingredient>(character)});
+const Ingredient* Character::addRight(CharacterId character) const {
+    const Ingredient* ingredients[] = {&characterTable[mId], &characterTable[character]};
+    return recipeInterner.intern(U'⿰', ingredients);
 }
 
-std::shared_ptr<Ingredient> Character::addAbove(std::shared_ptr<Character> character) {
-    return std::make_shared<Recipe>(U'⿱', 
-                                    std::vector<std::shared_ptr<Ingredient>>{
-                                        std::dynamic_pointer_cast<Ingredient>(character), 
-                                        std::dynamic_pointer_cast<Ingredient>(crafting::getCharacter(this->getCharacter()))});
+const Ingredient* Character::addAbove(CharacterId character) const {
+    const Ingredient* ingredients[] = {&characterTable[character], &characterTable[mId]};
+    return recipeInterner.intern(U'⿱', ingredients);
 }
 
-std::shared_ptr<Ingredient> Character::addBelow(std::shared_ptr<Character> character) {
-    return std::make_shared<Recipe>(U'⿱', 
-                                    std::vector<std::shared_ptr<Ingredient>>{
-                                        std::dynamic_pointer_cast<Ingredient>(crafting::getCharacter(this->getCharacter())), 
-                                        std::dynamic_pointer_cast<Ingredient>(character)});
+const Ingredient* Character::addBelow(CharacterId character) const {
+    const Ingredient* ingredients[] = {&characterTable[mId], &characterTable[character]};
+    return recipeInterner.intern(U'⿱', ingredients);
 }
 
 void Character::addRecipe(std::u32string recipeString) {
-    const char32_t* firstChar = recipeString.c_str();	
-    recipes.emplace_back(Recipe(recipeString));
+    Recipe recipe(recipeString);
+    addRecipe(recipe);
 }
 
 } // namespace crafting
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "CharacterTable.h"
+#include <stdexcept>
+#include <string>
+
+namespace crafting {
+
+CharacterTable::CharacterTable()
+    : bmpCjkIds(BMP_CJK_END - BMP_CJK_BEGIN, 0)
+    , sipCjkIds(SIP_CJK_END - SIP_CJK_BEGIN, 0)
+    , pages(MAX_CODE_POINT / PAGE_SIZE)
+{
+    // id 0 is no character
+    hot.push_back({});
+    cold.push_back(nullptr);
+    characters.emplace_back(CharacterId::NONE);
+}
+
+uint32_t* CharacterTable::slot(char32_t codePoint, bool create) {
+    if(codePoint >= BMP_CJK_BEGIN && codePoint < BMP_CJK_END) {
+        return &bmpCjkIds[codePoint - BMP_CJK_BEGIN];
+    }
+    if(codePoint >= SIP_CJK_BEGIN && codePoint < SIP_CJK_END) {
+        return &sipCjkIds[codePoint - SIP_CJK_BEGIN];
+    }
+    if(codePoint >= MAX_CODE_POINT) {
+        if(create) {
+            throw std::runtime_error("Invalid code point " + std::to_string(codePoint) + ".");
+        }
+        return nullptr;
+    }
+    std::unique_ptr<uint32_t[]>& page = pages[codePoint >> PAGE_BITS];
+    if(!page) {
+        if(!create) {
+            return nullptr;
+        }
+        page = std::make_unique<uint32_t[]>(PAGE_SIZE); // zero-initialized
+    }
+    return &page[codePoint & (PAGE_SIZE - 1)];
+}
+
+CharacterId CharacterTable::getId(char32_t codePoint) {
+    uint32_t* id = slot(codePoint, true);
+    if(*id == 0) {
+        *id = characters.size();
+        CharacterData& data = hot.emplace_back();
+        data.codePoint = codePoint;
+        cold.push_back(nullptr);
+        characters.emplace_back(CharacterId(*id));
+    }
+    return CharacterId(*id);
+}
+
+CharacterId CharacterTable::find(char32_t codePoint) const {
+    const uint32_t* id = const_cast<CharacterTable*>(this)->slot(codePoint, false);
+    return id ? CharacterId(*id) : CharacterId::NONE;
+}
+
+CharacterDetails& CharacterTable::details(CharacterId id) {
+    std::unique_ptr<CharacterDetails>& details = cold[uint32_t(id)];
+    if(!details) {
+        details = std::make_unique<CharacterDetails>();
+    }
+    return *details;
+}
+
+} // namespace crafting
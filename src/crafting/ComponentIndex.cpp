@@ -0,0 +1,129 @@
+#include "ComponentIndex.h"
+#include "hashMaps.h"
+#include <algorithm>
+
+namespace crafting {
+
+ComponentIndex componentIndex;
+
+/**
+ * @brief Collects the characters used in a recipe without duplicates.
+ * @param direct Filled with the recipe's own character ingredients.
+ * @param all Filled with all characters in the recipe's tree.
+*/
+static void collectComponents(const Recipe& recipe, std::vector<uint32_t>& direct, std::vector<uint32_t>& all) {
+    direct.clear();
+    all.clear();
+    thread_local std::vector<const Recipe*> stack;
+    stack.assign(1, &recipe);
+    while(!stack.empty()) {
+        const Recipe* current = stack.back();
+        stack.pop_back();
+        for(const Ingredient* ingredient : current->getIngredients()) {
+            if(ingredient->getKind() == IngredientKind::CHARACTER) {
+                uint32_t id = uint32_t(static_cast<const Character*>(ingredient)->getId());
+                all.push_back(id);
+                if(current == &recipe) {
+                    direct.push_back(id);
+                }
+            }
+            else if(ingredient->getKind() == IngredientKind::RECIPE) {
+                stack.push_back(static_cast<const Recipe*>(ingredient));
+            }
+        }
+    }
+    std::sort(direct.begin(), direct.end());
+    direct.erase(std::unique(direct.begin(), direct.end()), direct.end());
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+}
+
+void ComponentIndex::build() {
+    recipes.clear();
+    recipes.reserve(recipeMap.size());
+    for(const auto& entry : recipeMap) {
+        recipes.push_back(&entry.first);
+    }
+    std::sort(recipes.begin(), recipes.end(), [](const Recipe* a, const Recipe* b) { return a->getId() < b->getId(); });
+    recipeResults.clear();
+    recipeResults.reserve(recipes.size());
+    for(const Recipe* recipe : recipes) {
+        recipeResults.push_back(&recipeMap.at(*recipe));
+    }
+    resultRegions.reset(recipes.size());
+    for(uint32_t i = 0; i < recipes.size(); i++) {
+        resultRegions.count(i, recipeResults[i]->size());
+    }
+    resultRegions.allocate();
+    for(uint32_t i = 0; i < recipes.size(); i++) {
+        for(CharacterId result : *recipeResults[i]) {
+            const Character& character = characterTable[result];
+            const std::vector<Recipe>& characterRecipes = character.getRecipes();
+            size_t recipeIndex = std::find(characterRecipes.begin(), characterRecipes.end(), *recipes[i]) - characterRecipes.begin();
+            resultRegions.add(i, character.getRecipeRegions(recipeIndex));
+        }
+    }
+
+    size_t numKeys = characterTable.size() + 1;
+    directRecipes.reset(numKeys);
+    allRecipes.reset(numKeys);
+    std::vector<uint32_t> direct;
+    std::vector<uint32_t> all;
+    for(const Recipe* recipe : recipes) {
+        collectComponents(*recipe, direct, all);
+        for(uint32_t id : direct) {
+            directRecipes.count(id);
+        }
+        for(uint32_t id : all) {
+            allRecipes.count(id);
+        }
+    }
+    directRecipes.allocate();
+    allRecipes.allocate();
+    // recipes are added in index order, so every list is sorted
+    for(uint32_t i = 0; i < recipes.size(); i++) {
+        collectComponents(*recipes[i], direct, all);
+        for(uint32_t id : direct) {
+            directRecipes.add(id, i);
+        }
+        for(uint32_t id : all) {
+            allRecipes.add(id, i);
+        }
+    }
+
+    buildResults(directRecipes, directResults);
+    buildResults(allRecipes, allResults);
+}
+
+bool ComponentIndex::isActive(uint32_t index, CharacterId result, Region region) const {
+    const std::vector<CharacterId>& results = *recipeResults[index];
+    size_t variation = std::find(results.begin(), results.end(), result) - results.begin();
+    return variation < results.size() && isActiveIn(resultRegions[index][variation], region);
+}
+
+void ComponentIndex::buildResults(const util::PostingLists<uint32_t>& componentRecipes, util::PostingLists<CharacterId>& componentResults) {
+    size_t numKeys = componentRecipes.numKeys();
+    componentResults.reset(numKeys);
+    std::vector<CharacterId> results;
+    auto collectResults = [&](size_t component) {
+        results.clear();
+        for(uint32_t recipe : componentRecipes[component]) {
+            results.insert(results.end(), recipeResults[recipe]->begin(), recipeResults[recipe]->end());
+        }
+        std::sort(results.begin(), results.end());
+        results.erase(std::unique(results.begin(), results.end()), results.end());
+    };
+    for(size_t component = 0; component < numKeys; component++) {
+        collectResults(component);
+        componentResults.count(component, results.size());
+    }
+    componentResults.allocate();
+    for(size_t component = 0; component < numKeys; component++) {
+        collectResults(component);
+        for(CharacterId result : results) {
+            componentResults.add(component, result);
+        }
+    }
+}
+
+} // namespace crafting
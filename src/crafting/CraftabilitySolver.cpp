@@ -0,0 +1,392 @@
+#include "CraftabilitySolver.h"
+#include "ComponentIndex.h"
+#include "hashMaps.h"
+#include "VariantClasses.h"
+#include "parallelUtil.h"
+#include <algorithm>
+#include <memory>
+
+namespace crafting {
+
+CraftabilitySolver craftabilitySolver;
+
+// How many crafts deep a chain of crafts is followed when checking item amounts.
+static constexpr int MAX_CRAFT_DEPTH = 8;
+// How many steps checking a single candidate may take before it is given up on.
+static constexpr size_t MAX_VERIFY_STEPS = 100000;
+
+/**
+ * @brief Counts the characters used in a recipe's tree by the representatives of their variant classes, sorted by id.
+*/
+static void countRequirements(const Recipe& recipe, std::vector<Requirement>& out) {
+    thread_local std::vector<uint32_t> leaves;
+    thread_local std::vector<const Recipe*> stack;
+    leaves.clear();
+    stack.assign(1, &recipe);
+    while(!stack.empty()) {
+        const Recipe* current = stack.back();
+        stack.pop_back();
+        for(const Ingredient* ingredient : current->getIngredients()) {
+            if(ingredient->getKind() == IngredientKind::CHARACTER) {
+                leaves.push_back(uint32_t(variantClasses.getRepresentative(static_cast<const Character*>(ingredient)->getId())));
+            }
+            else if(ingredient->getKind() == IngredientKind::RECIPE) {
+                stack.push_back(static_cast<const Recipe*>(ingredient));
+            }
+        }
+    }
+    std::sort(leaves.begin(), leaves.end());
+    out.clear();
+    for(uint32_t leaf : leaves) {
+        if(!out.empty() && out.back().character == CharacterId(leaf)) {
+            out.back().count++;
+        }
+        else {
+            out.push_back({CharacterId(leaf), 1});
+        }
+    }
+}
+
+void CraftabilitySolver::build() {
+    size_t numRecipes = componentIndex.size();
+    std::vector<Requirement> recipeRequirements;
+    requirements.reset(numRecipes);
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        countRequirements(componentIndex.getRecipe(i), recipeRequirements);
+        requirements.count(i, recipeRequirements.size());
+    }
+    requirements.allocate();
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        countRequirements(componentIndex.getRecipe(i), recipeRequirements);
+        for(const Requirement& requirement : recipeRequirements) {
+            requirements.add(i, requirement);
+        }
+    }
+
+    producers.reset(characterTable.size() + 1);
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        for(CharacterId result : componentIndex.getResults(i)) {
+            producers.count(uint32_t(result));
+        }
+    }
+    producers.allocate();
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        for(CharacterId result : componentIndex.getResults(i)) {
+            producers.add(uint32_t(result), i);
+        }
+    }
+
+    consumers.reset(characterTable.size() + 1);
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        for(const Requirement& requirement : requirements[i]) {
+            consumers.count(uint32_t(requirement.character));
+        }
+    }
+    consumers.allocate();
+    for(uint32_t i = 0; i < numRecipes; i++) {
+        for(const Requirement& requirement : requirements[i]) {
+            consumers.add(uint32_t(requirement.character), i);
+        }
+    }
+}
+
+util::ArrayView<uint32_t> CraftabilitySolver::getConsumers(CharacterId character) const {
+    return consumers[uint32_t(variantClasses.getRepresentative(character))];
+}
+
+std::vector<CharacterId> CraftabilitySolver::findCraftable(const inventory::Inventory& inventory, Region region) const {
+    util::Bitset checked(requirements.numKeys());
+    util::Bitset craftable(characterTable.size() + 1);
+    for(const auto& item : inventory.getItems()) {
+        // only recipes that use at least one of the items or their variants can be craftable
+        for(uint32_t recipe : getConsumers(item.first)) {
+            if(!checked.insert(recipe)) {
+                continue;
+            }
+            bool enough = true;
+            for(const Requirement& requirement : requirements[recipe]) {
+                if(!inventory.hasItem(requirement.character, requirement.count)) {
+                    enough = false;
+                    break;
+                }
+            }
+            if(enough) {
+                for(CharacterId result : componentIndex.getResults(recipe)) {
+                    if(componentIndex.isActive(recipe, result, region)) {
+                        craftable.set(uint32_t(result));
+                    }
+                }
+            }
+        }
+    }
+    std::vector<CharacterId> result;
+    craftable.forEach([&](size_t id) { result.push_back(CharacterId(id)); });
+    return result;
+}
+
+util::Bitset CraftabilitySolver::findReachableIgnoringQuantities(const inventory::Inventory& inventory, Region region, util::Bitset& classes) const {
+    util::Bitset reachable(characterTable.size() + 1);
+    classes.resize(characterTable.size() + 1);
+    classes.clear();
+    for(const auto& item : inventory.getItems()) {
+        reachable.set(uint32_t(item.first));
+        classes.set(uint32_t(variantClasses.getRepresentative(item.first)));
+    }
+    // the number of distinct classes each recipe still needs, a recipe fires once it needs none
+    size_t numRecipes = requirements.numKeys();
+    std::vector<uint32_t> missing(numRecipes);
+    std::vector<uint32_t> firing;
+    for(uint32_t recipe = 0; recipe < numRecipes; recipe++) {
+        for(const Requirement& requirement : requirements[recipe]) {
+            missing[recipe] += !classes.test(uint32_t(requirement.character));
+        }
+        if(missing[recipe] == 0) {
+            firing.push_back(recipe);
+        }
+    }
+    std::vector<CharacterId> worklist;
+    auto fire = [&](uint32_t recipe) {
+        for(CharacterId result : componentIndex.getResults(recipe)) {
+            if(componentIndex.isActive(recipe, result, region) && reachable.insert(uint32_t(result))) {
+                CharacterId representative = variantClasses.getRepresentative(result);
+                if(classes.insert(uint32_t(representative))) {
+                    worklist.push_back(representative);
+                }
+            }
+        }
+    };
+    for(uint32_t recipe : firing) {
+        fire(recipe);
+    }
+    while(!worklist.empty()) {
+        CharacterId representative = worklist.back();
+        worklist.pop_back();
+        for(uint32_t recipe : consumers[uint32_t(representative)]) {
+            if(--missing[recipe] == 0) {
+                fire(recipe);
+            }
+        }
+    }
+    return reachable;
+}
+
+/**
+ * @brief Checks whether single characters can be obtained from the inventory with the items it actually has.
+ * Like Inventory::removeIngredients, a required character can be taken as any of its variants.
+ *
+ * The search is depth-first over the items still to be obtained. Every item is either taken from the stock or crafted
+ * by one of the recipes making it, and when a later item can not be obtained, the search goes back to the most recent
+ * item with ways left to try, undoing everything after it. So a character is only rejected once every combination of
+ * choices failed, unless the search runs into MAX_CRAFT_DEPTH or MAX_VERIFY_STEPS first; it never accepts a character
+ * that can not be obtained. The search keeps its own stacks instead of recursing, so deep searches do not overflow the stack.
+*/
+class CraftabilitySolver::Verifier {
+private:
+    enum class GoalKind : uint8_t {
+        OBTAIN, // one item of the variant class of a representative, from the stock or crafted
+        CRAFT,  // one item of exactly the character, by one of its recipes
+        FINISH  // the craft of the character is complete, so it may be crafted again
+    };
+    struct Goal {
+        GoalKind kind;
+        CharacterId character;
+        int depth;
+    };
+    /**
+     * @brief A goal that was started, with the next of its ways to try and what to go back to before trying it.
+    */
+    struct Choice {
+        Goal goal;
+        uint32_t next;
+        size_t numGoals;
+        size_t numChanges;
+    };
+    enum class ChangeKind : uint8_t {
+        TAKE,  // an item was taken from the stock
+        START, // a character was marked as being crafted
+        END    // a character was unmarked as being crafted
+    };
+    struct Change {
+        ChangeKind kind;
+        CharacterId character;
+    };
+
+    const CraftabilitySolver& solver;
+    Region region;
+    // The variant classes that can be reached at all, recipes needing anything else are not tried.
+    const util::Bitset& reachableClasses;
+    // The remaining amount of every variant class, by the id of its representative.
+    std::vector<uint32_t> stock;
+    // The characters currently being crafted, to not go in circles.
+    util::Bitset crafting;
+    // The goals still to be reached, the next one last.
+    std::vector<Goal> goals;
+    std::vector<Choice> choices;
+    // Everything changed in the stock and crafting, to undo it when going back.
+    std::vector<Change> changes;
+
+    void undo(size_t numChanges) {
+        while(changes.size() > numChanges) {
+            const Change& change = changes.back();
+            switch(change.kind) {
+                case ChangeKind::TAKE: stock[uint32_t(change.character)]++; break;
+                case ChangeKind::START: crafting.reset(uint32_t(change.character)); break;
+                case ChangeKind::END: crafting.set(uint32_t(change.character)); break;
+            }
+            changes.pop_back();
+        }
+    }
+
+    /**
+     * @brief Whether the recipe can make the character in the region from reachable classes only.
+    */
+    bool isUsable(uint32_t recipe, CharacterId character) const {
+        util::ArrayView<Requirement> needed = solver.requirements[recipe];
+        return componentIndex.isActive(recipe, character, region)
+            && std::all_of(needed.begin(), needed.end(), [&](const Requirement& r) { return reachableClasses.test(uint32_t(r.character)); });
+    }
+
+    /**
+     * @brief Goes back to the state before the choice was made and applies its next way, pushing the goals it leads to.
+     * @return True if there was a way left, false if all were tried.
+    */
+    bool tryNext(Choice& choice) {
+        undo(choice.numChanges);
+        goals.resize(choice.numGoals);
+        const Goal& goal = choice.goal;
+        uint32_t id = uint32_t(goal.character);
+        switch(goal.kind) {
+            case GoalKind::OBTAIN: {
+                // first from the stock, then by crafting each of the variants
+                if(choice.next == 0) {
+                    choice.next++;
+                    if(stock[id] > 0) {
+                        stock[id]--;
+                        changes.push_back({ChangeKind::TAKE, goal.character});
+                        return true;
+                    }
+                }
+                util::ArrayView<CharacterId> variants = variantClasses.getVariants(goal.character);
+                if(choice.next - 1 < variants.size()) {
+                    goals.push_back({GoalKind::CRAFT, variants[choice.next - 1], goal.depth});
+                    choice.next++;
+                    return true;
+                }
+                return false;
+            }
+            case GoalKind::CRAFT: {
+                if(goal.depth == MAX_CRAFT_DEPTH || crafting.test(id)) {
+                    return false;
+                }
+                util::ArrayView<uint32_t> recipes = solver.producers[id];
+                while(choice.next < recipes.size()) {
+                    uint32_t recipe = recipes[choice.next++];
+                    if(!isUsable(recipe, goal.character)) {
+                        continue;
+                    }
+                    crafting.set(id);
+                    changes.push_back({ChangeKind::START, goal.character});
+                    goals.push_back({GoalKind::FINISH, goal.character, goal.depth});
+                    // pushed in reverse, so the requirements are obtained in order
+                    util::ArrayView<Requirement> needed = solver.requirements[recipe];
+                    for(size_t i = needed.size(); i-- > 0;) {
+                        for(uint32_t j = 0; j < needed[i].count; j++) {
+                            goals.push_back({GoalKind::OBTAIN, needed[i].character, goal.depth + 1});
+                        }
+                    }
+                    return true;
+                }
+                return false;
+            }
+            case GoalKind::FINISH:
+                if(choice.next > 0) {
+                    return false;
+                }
+                choice.next++;
+                crafting.reset(id);
+                changes.push_back({ChangeKind::END, goal.character});
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reaches all goals, going back to earlier choices when a goal can not be reached.
+     * @return True if all goals were reached, false if there is no way or the search took too many steps.
+    */
+    bool search() {
+        size_t steps = 0;
+        while(!goals.empty()) {
+            if(++steps > MAX_VERIFY_STEPS) {
+                return false;
+            }
+            Goal goal = goals.back();
+            goals.pop_back();
+            choices.push_back({goal, 0, goals.size(), changes.size()});
+            while(!tryNext(choices.back())) {
+                // no way of the goal is left, it has to be reached again once an earlier choice went another way
+                goals.push_back(choices.back().goal);
+                choices.pop_back();
+                if(choices.empty()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+public:
+    Verifier(const CraftabilitySolver& solver, const inventory::Inventory& inventory, Region region, const util::Bitset& reachableClasses)
+        : solver(solver)
+        , region(region)
+        , reachableClasses(reachableClasses)
+        , stock(characterTable.size() + 1, 0)
+        , crafting(characterTable.size() + 1)
+    {
+        for(const auto& item : inventory.getItems()) {
+            stock[uint32_t(variantClasses.getRepresentative(item.first))] += item.second;
+        }
+    }
+
+    /**
+     * @brief Checks whether the character can be crafted. The stock is the same as before afterwards.
+    */
+    bool canObtain(CharacterId character) {
+        goals.assign(1, {GoalKind::CRAFT, character, 0});
+        bool result = search();
+        undo(0);
+        goals.clear();
+        choices.clear();
+        return result;
+    }
+};
+
+std::vector<CharacterId> CraftabilitySolver::findReachable(const inventory::Inventory& inventory, Region region, unsigned int threads) const {
+    util::Bitset reachableClasses;
+    util::Bitset reachable = findReachableIgnoringQuantities(inventory, region, reachableClasses);
+    std::vector<CharacterId> candidates;
+    reachable.forEach([&](size_t id) {
+        if(!inventory.hasItem(CharacterId(id))) {
+            candidates.push_back(CharacterId(id));
+        }
+    });
+
+    threads = util::threadCount(threads);
+    std::vector<std::unique_ptr<Verifier>> verifiers(threads);
+    std::vector<char> verified(candidates.size(), false);
+    util::parallelFor(candidates.size(), [&](size_t index, unsigned int worker) {
+        if(!verifiers[worker]) {
+            verifiers[worker] = std::make_unique<Verifier>(*this, inventory, region, reachableClasses);
+        }
+        verified[index] = verifiers[worker]->canObtain(candidates[index]);
+    }, threads);
+
+    std::vector<CharacterId> result;
+    for(size_t i = 0; i < candidates.size(); i++) {
+        if(verified[i]) {
+            result.push_back(candidates[i]);
+        }
+    }
+    return result;
+}
+
+} // namespace crafting
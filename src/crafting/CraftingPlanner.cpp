@@ -0,0 +1,220 @@
+#include "CraftingPlanner.h"
+#include "ComponentIndex.h"
+#include "CraftabilitySolver.h"
+#include "hashMaps.h"
+#include "VariantClasses.h"
+#include <algorithm>
+#include <iterator>
+
+namespace crafting {
+
+// How many crafts deep a plan may go.
+static constexpr int MAX_PLAN_DEPTH = 32;
+
+static uint32_t addCosts(uint32_t a, uint32_t b) {
+    return a > UINT32_MAX - b ? UINT32_MAX : a + b;
+}
+
+CraftingPlanner::CraftingPlanner(CraftCosts costs)
+    : costs(costs)
+{
+    this->costs.perItem = std::max<uint32_t>(costs.perItem, 1);
+}
+
+uint32_t CraftingPlanner::classCost(CharacterId representative) const {
+    uint32_t result = UNREACHABLE;
+    for(CharacterId variant : variantClasses.getVariants(representative)) {
+        result = std::min(result, cost[uint32_t(variant)]);
+    }
+    return result;
+}
+
+uint32_t CraftingPlanner::recipeCost(uint32_t recipe) const {
+    uint32_t result = costs.perCraft;
+    for(const Requirement& requirement : craftabilitySolver.getRequirements(recipe)) {
+        uint32_t requirementCost = classCost(requirement.character);
+        if(requirementCost == UNREACHABLE) {
+            return UNREACHABLE;
+        }
+        for(uint32_t i = 0; i < requirement.count; i++) {
+            result = addCosts(result, requirementCost);
+        }
+    }
+    return result;
+}
+
+void CraftingPlanner::offer(uint32_t character, uint32_t recipe, uint32_t recipeCost) {
+    if(recipeCost >= craftCost[character]) {
+        return;
+    }
+    craftCost[character] = recipeCost;
+    craftRecipe[character] = recipe;
+    if(recipeCost < cost[character]) {
+        cost[character] = recipeCost;
+        queue.push({recipeCost, character});
+    }
+}
+
+void CraftingPlanner::propagate() {
+    while(!queue.empty()) {
+        auto [characterCost, character] = queue.top();
+        queue.pop();
+        if(characterCost != cost[character]) {
+            continue; // lowered again since it was queued
+        }
+        for(uint32_t recipe : craftabilitySolver.getConsumers(CharacterId(character))) {
+            uint32_t newCost = recipeCost(recipe);
+            if(newCost == UNREACHABLE) {
+                continue;
+            }
+            for(CharacterId result : componentIndex.getResults(recipe)) {
+                if(componentIndex.isActive(recipe, result, region)) {
+                    offer(uint32_t(result), recipe, newCost);
+                }
+            }
+        }
+    }
+}
+
+void CraftingPlanner::raise(const std::vector<CharacterId>& lost) {
+    // everything crafted with a lost class through the cheapest recipes may have become more expensive
+    util::Bitset affected(cost.size());
+    std::vector<uint32_t> affectedList;
+    for(CharacterId representative : lost) {
+        for(CharacterId variant : variantClasses.getVariants(representative)) {
+            if(affected.insert(uint32_t(variant))) {
+                affectedList.push_back(uint32_t(variant));
+            }
+        }
+    }
+    for(size_t i = 0; i < affectedList.size(); i++) {
+        for(uint32_t recipe : craftabilitySolver.getConsumers(CharacterId(affectedList[i]))) {
+            for(CharacterId result : componentIndex.getResults(recipe)) {
+                if(craftRecipe[uint32_t(result)] == recipe && affected.insert(uint32_t(result))) {
+                    affectedList.push_back(uint32_t(result));
+                }
+            }
+        }
+    }
+    for(uint32_t character : affectedList) {
+        cost[character] = owned.test(uint32_t(variantClasses.getRepresentative(CharacterId(character)))) ? costs.perItem : UNREACHABLE;
+        craftCost[character] = UNREACHABLE;
+        craftRecipe[character] = NO_RECIPE;
+    }
+    // the costs of the unaffected characters are still correct, so the affected ones can start from them
+    for(uint32_t character : affectedList) {
+        for(uint32_t recipe : craftabilitySolver.getProducers(CharacterId(character))) {
+            uint32_t newCost = recipeCost(recipe);
+            if(newCost != UNREACHABLE && componentIndex.isActive(recipe, CharacterId(character), region)) {
+                offer(character, recipe, newCost);
+            }
+        }
+        if(cost[character] != UNREACHABLE) {
+            queue.push({cost[character], character});
+        }
+    }
+}
+
+void CraftingPlanner::update(const inventory::Inventory& inventory, Region region) {
+    size_t numCharacters = characterTable.size() + 1;
+    if(cost.size() != numCharacters || craftRecipe.size() != numCharacters || region != this->region) {
+        this->region = region;
+        owned.resize(numCharacters);
+        owned.clear();
+        ownedList.clear();
+        cost.assign(numCharacters, UNREACHABLE);
+        craftCost.assign(numCharacters, UNREACHABLE);
+        craftRecipe.assign(numCharacters, NO_RECIPE);
+    }
+
+    // the classes are collected from the items themselves, hasItem only tells about classes asked for
+    std::vector<CharacterId> classes;
+    for(const auto& item : inventory.getItems()) {
+        if(item.second > 0) {
+            classes.push_back(variantClasses.getRepresentative(item.first));
+        }
+    }
+    std::sort(classes.begin(), classes.end());
+    classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+    std::vector<CharacterId> gained;
+    std::vector<CharacterId> lost;
+    std::set_difference(classes.begin(), classes.end(), ownedList.begin(), ownedList.end(), std::back_inserter(gained));
+    std::set_difference(ownedList.begin(), ownedList.end(), classes.begin(), classes.end(), std::back_inserter(lost));
+    if(gained.empty() && lost.empty()) {
+        return;
+    }
+    for(CharacterId representative : lost) {
+        owned.reset(uint32_t(representative));
+    }
+    for(CharacterId representative : gained) {
+        owned.set(uint32_t(representative));
+    }
+    ownedList = std::move(classes);
+
+    if(!lost.empty()) {
+        raise(lost);
+    }
+    for(CharacterId representative : gained) {
+        for(CharacterId variant : variantClasses.getVariants(representative)) {
+            if(costs.perItem < cost[uint32_t(variant)]) {
+                cost[uint32_t(variant)] = costs.perItem;
+                queue.push({costs.perItem, uint32_t(variant)});
+            }
+        }
+    }
+    propagate();
+}
+
+uint32_t CraftingPlanner::getCost(CharacterId character) const {
+    return uint32_t(character) < cost.size() ? cost[uint32_t(character)] : UNREACHABLE;
+}
+
+bool CraftingPlanner::expand(CharacterId character, const inventory::Inventory& inventory, bool fromInventory, int depth,
+        std::unordered_map<uint32_t, unsigned int>& taken, std::vector<CraftStep>& steps) const {
+    if(fromInventory) {
+        // items from the inventory are never more expensive than crafting, since every recipe needs at least one item
+        unsigned int& amount = taken[uint32_t(variantClasses.getRepresentative(character))];
+        if(inventory.hasItem(character, amount + 1)) {
+            amount++;
+            return true;
+        }
+        // otherwise the cheapest variant to craft is crafted
+        for(CharacterId variant : variantClasses.getVariants(character)) {
+            if(craftCost[uint32_t(variant)] < craftCost[uint32_t(character)]) {
+                character = variant;
+            }
+        }
+    }
+    uint32_t id = uint32_t(character);
+    uint32_t recipe = craftRecipe[id];
+    if(recipe == NO_RECIPE || depth == MAX_PLAN_DEPTH) {
+        return false;
+    }
+    for(const Requirement& requirement : craftabilitySolver.getRequirements(recipe)) {
+        for(uint32_t i = 0; i < requirement.count; i++) {
+            if(!expand(requirement.character, inventory, true, depth + 1, taken, steps)) {
+                return false;
+            }
+        }
+    }
+    const std::vector<CharacterId>& results = componentIndex.getResults(recipe);
+    unsigned int variation = std::find(results.begin(), results.end(), character) - results.begin();
+    steps.push_back({&componentIndex.getRecipe(recipe), variation, character});
+    return true;
+}
+
+bool CraftingPlanner::plan(const inventory::Inventory& inventory, Region region, CharacterId target, std::vector<CraftStep>& steps) {
+    update(inventory, region);
+    steps.clear();
+    if(uint32_t(target) >= craftCost.size() || craftCost[uint32_t(target)] == UNREACHABLE) {
+        return false;
+    }
+    std::unordered_map<uint32_t, unsigned int> taken;
+    if(!expand(target, inventory, false, 0, taken, steps)) {
+        steps.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace crafting
@@ -0,0 +1,110 @@
+#include "DecompositionTable.h"
+#include "hashMaps.h"
+#include <algorithm>
+
+namespace crafting {
+
+DecompositionTables decompositionTables;
+
+/**
+ * @brief Collects the characters used in a recipe, once for every use.
+*/
+static void collectLeaves(const Recipe& recipe, std::vector<uint32_t>& leaves) {
+    std::vector<const Recipe*> stack{&recipe};
+    while(!stack.empty()) {
+        const Recipe* current = stack.back();
+        stack.pop_back();
+        for(const Ingredient* ingredient : current->getIngredients()) {
+            if(ingredient->getKind() == IngredientKind::CHARACTER) {
+                leaves.push_back(uint32_t(static_cast<const Character*>(ingredient)->getId()));
+            }
+            else if(ingredient->getKind() == IngredientKind::RECIPE) {
+                stack.push_back(static_cast<const Recipe*>(ingredient));
+            }
+        }
+    }
+}
+
+void DecompositionTable::decompose(uint32_t character, std::vector<uint8_t>& state) {
+    state[character] = 1;
+    const Recipe* recipe = characterTable[CharacterId(character)].getActiveRecipe(region);
+    std::vector<PrimitiveCount> result;
+    if(!recipe) {
+        result.push_back({CharacterId(character), 1});
+    }
+    else {
+        std::vector<uint32_t> leaves;
+        collectLeaves(*recipe, leaves);
+        for(uint32_t leaf : leaves) {
+            if(state[leaf] == 1) {
+                // the leaf is still being decomposed, so the recipe refers back to it
+                cyclic.set(character);
+                result.push_back({CharacterId(leaf), 1});
+                continue;
+            }
+            if(state[leaf] == 0) {
+                decompose(leaf, state);
+            }
+            if(cyclic.test(leaf)) {
+                cyclic.set(character);
+            }
+            const Range& range = ranges[leaf];
+            result.insert(result.end(), primitives.begin() + range.first, primitives.begin() + range.first + range.size);
+        }
+        std::sort(result.begin(), result.end(), [](const PrimitiveCount& a, const PrimitiveCount& b) { return a.character < b.character; });
+        size_t merged = 0;
+        for(size_t i = 1; i < result.size(); i++) {
+            if(result[i].character == result[merged].character) {
+                result[merged].count += result[i].count;
+            }
+            else {
+                result[++merged] = result[i];
+            }
+        }
+        result.resize(merged + 1);
+    }
+    uint32_t total = 0;
+    for(const PrimitiveCount& primitive : result) {
+        total += primitive.count;
+    }
+    ranges[character] = {uint32_t(primitives.size()), uint32_t(result.size())};
+    totals[character] = total;
+    primitives.insert(primitives.end(), result.begin(), result.end());
+    state[character] = 2;
+}
+
+void DecompositionTable::build(Region region) {
+    this->region = region;
+    size_t numCharacters = characterTable.size() + 1;
+    primitives.clear();
+    ranges.assign(numCharacters, {0, 0});
+    totals.assign(numCharacters, 0);
+    cyclic.resize(numCharacters);
+    cyclic.clear();
+    std::vector<uint8_t> state(numCharacters, 0);
+    // the decompositions are memoized, so every character is decomposed once after the characters it consists of
+    for(uint32_t character = 1; character < numCharacters; character++) {
+        if(state[character] == 0) {
+            decompose(character, state);
+        }
+    }
+}
+
+const DecompositionTable& DecompositionTables::get(Region region) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<DecompositionTable>& table = tables[size_t(region)];
+    if(!table) {
+        table = std::make_unique<DecompositionTable>();
+        table->build(region);
+    }
+    return *table;
+}
+
+void DecompositionTables::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for(std::unique_ptr<DecompositionTable>& table : tables) {
+        table.reset();
+    }
+}
+
+} // namespace crafting
@@ -0,0 +1,225 @@
+#include "DictionaryData.h"
+#include "hashMaps.h"
+#include <algorithm>
+#include <charconv>
+
+namespace crafting {
+
+DictionaryData dictionaryData;
+
+static constexpr int CANGJIE_LENGTH = 5;
+static constexpr int CANGJIE_BITS = 5;
+static constexpr int FOUR_CORNER_LENGTH = 5;
+static constexpr int FOUR_CORNER_BITS = 4;
+
+/**
+ * @brief Packs a code or a prefix of it, see DictionaryData.h.
+ * @param symbolOf Gets the number of a character of the code from 1, or 0 if it is not a symbol of the code.
+ * @return The number of symbols, or -1 if the code is too long or contains other characters.
+*/
+template<typename SymbolOf>
+static int packSymbols(std::string_view code, int length, int bits, SymbolOf symbolOf, uint32_t& packed) {
+    if(code.size() > size_t(length)) {
+        return -1;
+    }
+    packed = 0;
+    for(int i = 0; i < length; i++) {
+        uint32_t symbol = 0;
+        if(size_t(i) < code.size()) {
+            symbol = symbolOf(code[i]);
+            if(symbol == 0) {
+                return -1;
+            }
+        }
+        packed = packed << bits | symbol;
+    }
+    return int(code.size());
+}
+
+template<typename CharOf>
+static std::string unpackSymbols(uint32_t packed, int length, int bits, CharOf charOf) {
+    std::string code;
+    for(int i = length - 1; i >= 0; i--) {
+        uint32_t symbol = packed >> (i * bits) & ((1 << bits) - 1);
+        if(symbol == 0) {
+            break;
+        }
+        code += charOf(symbol);
+    }
+    return code;
+}
+
+// Lowercase letters are accepted for typing.
+static uint32_t cangjieSymbol(char c) {
+    if(c >= 'a' && c <= 'z') {
+        c += 'A' - 'a';
+    }
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 1 : 0;
+}
+
+static int packCangjieSymbols(std::string_view code, uint32_t& packed) {
+    return packSymbols(code, CANGJIE_LENGTH, CANGJIE_BITS, cangjieSymbol, packed);
+}
+
+static int packFourCornerSymbols(std::string_view code, uint32_t& packed) {
+    // the four corners, then the supplementary corner, which is written after a dot, e.g. 4090.0
+    char digits[FOUR_CORNER_LENGTH];
+    size_t numDigits = 0;
+    for(size_t i = 0; i < code.size(); i++) {
+        if(i == 4 && code[i] == '.') {
+            continue;
+        }
+        if(numDigits == FOUR_CORNER_LENGTH) {
+            return -1;
+        }
+        digits[numDigits++] = code[i];
+    }
+    auto digitSymbol = [](char c) { return c >= '0' && c <= '9' ? uint32_t(c - '0' + 1) : 0; };
+    return packSymbols(std::string_view(digits, numDigits), FOUR_CORNER_LENGTH, FOUR_CORNER_BITS, digitSymbol, packed);
+}
+
+/**
+ * @brief Gets the range of packed codes starting with a packed prefix of the given number of symbols.
+*/
+static std::pair<uint32_t, uint32_t> prefixRange(uint32_t packed, int numSymbols, int length, int bits) {
+    if(numSymbols < 0) {
+        return {0, 0};
+    }
+    return {packed, packed + (uint32_t(1) << ((length - numSymbols) * bits))};
+}
+
+uint32_t packCangjie(std::string_view code) {
+    uint32_t packed;
+    return packCangjieSymbols(code, packed) > 0 ? packed : 0;
+}
+
+std::string unpackCangjie(uint32_t packed) {
+    return unpackSymbols(packed, CANGJIE_LENGTH, CANGJIE_BITS, [](uint32_t symbol) { return char('A' + symbol - 1); });
+}
+
+std::pair<uint32_t, uint32_t> cangjiePrefixRange(std::string_view prefix) {
+    uint32_t packed;
+    int numSymbols = packCangjieSymbols(prefix, packed);
+    return prefixRange(packed, numSymbols, CANGJIE_LENGTH, CANGJIE_BITS);
+}
+
+uint32_t packFourCornerCode(std::string_view code) {
+    uint32_t packed;
+    int numSymbols = packFourCornerSymbols(code, packed);
+    bool complete = (numSymbols == 4 && code.size() == 4) || (numSymbols == 5 && code.size() == 6);
+    return complete ? packed : 0;
+}
+
+std::string unpackFourCornerCode(uint32_t packed) {
+    std::string code = unpackSymbols(packed, FOUR_CORNER_LENGTH, FOUR_CORNER_BITS, [](uint32_t symbol) { return char('0' + symbol - 1); });
+    if(code.size() == FOUR_CORNER_LENGTH) {
+        code.insert(4, 1, '.');
+    }
+    return code;
+}
+
+std::pair<uint32_t, uint32_t> fourCornerPrefixRange(std::string_view prefix) {
+    uint32_t packed;
+    int numSymbols = packFourCornerSymbols(prefix, packed);
+    return prefixRange(packed, numSymbols, FOUR_CORNER_LENGTH, FOUR_CORNER_BITS);
+}
+
+/**
+ * @brief Parses a small number, e.g. a kFrequency, and checks that it is in the given range.
+ * @return The number, or 0 if it is invalid.
+*/
+static uint8_t parseSmallNumber(std::string_view value, int min, int max) {
+    int number = 0;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+    if(result.ec != std::errc() || result.ptr != value.data() + value.size() || number < min || number > max) {
+        return 0;
+    }
+    return uint8_t(number);
+}
+
+template<typename T>
+static void setValue(std::vector<T>& column, CharacterId character, T value) {
+    if(column.size() <= uint32_t(character)) {
+        column.resize(characterTable.size() + 1);
+    }
+    column[uint32_t(character)] = value;
+}
+
+void DictionaryData::reset(DictionaryFieldMask fields) {
+    loadedFields = fields;
+    cangjie.clear();
+    frequencies.clear();
+    gradeLevels.clear();
+    coreRegions.clear();
+    pendingFourCornerCodes.clear();
+    fourCornerCodes.reset(0);
+    fourCornerCodes.allocate();
+}
+
+bool DictionaryData::add(CharacterId character, DictionaryField field, std::string_view value) {
+    switch(field) {
+        case DictionaryField::CANGJIE:
+            return addPacked(character, field, packCangjie(value));
+        case DictionaryField::FOUR_CORNER_CODE: {
+            // several codes are separated by spaces, e.g. "4090.0 4091.0"
+            bool added = false;
+            while(!value.empty()) {
+                size_t end = std::min(value.find(' '), value.size());
+                added |= addPacked(character, field, packFourCornerCode(value.substr(0, end)));
+                value.remove_prefix(std::min(end + 1, value.size()));
+            }
+            return added;
+        }
+        case DictionaryField::FREQUENCY:
+            return addPacked(character, field, parseSmallNumber(value, 1, 5));
+        case DictionaryField::GRADE_LEVEL:
+            return addPacked(character, field, parseSmallNumber(value, 1, 6));
+        case DictionaryField::UNIHAN_CORE_2020:
+            // the source letters of the regions, e.g. "GHJKMPT"
+            return addPacked(character, field, parseRegions(value));
+        default:
+            return false;
+    }
+}
+
+bool DictionaryData::addPacked(CharacterId character, DictionaryField field, uint32_t value) {
+    if(!isLoaded(field) || character == CharacterId::NONE || value == 0) {
+        return false;
+    }
+    switch(field) {
+        case DictionaryField::CANGJIE:
+            setValue(cangjie, character, value);
+            return true;
+        case DictionaryField::FOUR_CORNER_CODE:
+            pendingFourCornerCodes.push_back({character, value});
+            return true;
+        case DictionaryField::FREQUENCY:
+            setValue(frequencies, character, uint8_t(value));
+            return true;
+        case DictionaryField::GRADE_LEVEL:
+            setValue(gradeLevels, character, uint8_t(value));
+            return true;
+        case DictionaryField::UNIHAN_CORE_2020:
+            setValue(coreRegions, character, RegionMask(value));
+            return true;
+        default:
+            return false;
+    }
+}
+
+void DictionaryData::build() {
+    // stable, so the codes of a character keep their order in the file
+    std::stable_sort(pendingFourCornerCodes.begin(), pendingFourCornerCodes.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    fourCornerCodes.reset(characterTable.size() + 1);
+    for(const auto& [character, code] : pendingFourCornerCodes) {
+        fourCornerCodes.count(uint32_t(character));
+    }
+    fourCornerCodes.allocate();
+    for(const auto& [character, code] : pendingFourCornerCodes) {
+        fourCornerCodes.add(uint32_t(character), code);
+    }
+    pendingFourCornerCodes.clear();
+    pendingFourCornerCodes.shrink_to_fit();
+}
+
+} // namespace crafting
@@ -1,40 +1,35 @@
 #include "EmptyIngredient.h"
 #include "Character.h"
+#include "hashMaps.h"
 
 namespace crafting {
 
 bool EmptyIngredient::operator==(const Ingredient& other) const {
-    try {
-        dynamic_cast<const EmptyIngredient&>(other);
-        return true;
-    }
-    catch(std::bad_cast& e) {
-        return false;
-    }
+    return other.getKind() == IngredientKind::EMPTY;
 }
 
 EmptyIngredient::operator std::u32string() const {
     return std::u32string();
 }
 
-rendering::GreyBitmap EmptyIngredient::render(int width, int height) const {
+rendering::GreyBitmap EmptyIngredient::render(int width, int height, Region) const {
     return rendering::GreyBitmap(width, height);
 }
 
-std::shared_ptr<Ingredient> EmptyIngredient::addLeft(std::shared_ptr<Character> character) {
-    return character;
+const Ingredient* EmptyIngredient::addLeft(CharacterId character) const {
+    return &characterTable[character];
 }
 
-std::shared_ptr<Ingredient> EmptyIngredient::addRight(std::shared_ptr<Character> character) {
-    return character;
+const Ingredient* EmptyIngredient::addRight(CharacterId character) const {
+    return &characterTable[character];
 }
 
-std::shared_ptr<Ingredient> EmptyIngredient::addAbove(std::shared_ptr<Character> character) {
-    return character;
+const Ingredient* EmptyIngredient::addAbove(CharacterId character) const {
+    return &characterTable[character];
 }
 
-std::shared_ptr<Ingredient> EmptyIngredient::addBelow(std::shared_ptr<Character> character) {
-    return character;
+const Ingredient* EmptyIngredient::addBelow(CharacterId character) const {
+    return &characterTable[character];
 }
 
 } // namespace crafting
\ No newline at end of file
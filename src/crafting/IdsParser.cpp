@@ -0,0 +1,79 @@
+#include "IdsParser.h"
+
+namespace crafting {
+
+IdsTree IdsParser::parse(std::u32string_view ids) {
+    mNodes.clear();
+    parseInto(ids, mNodes);
+    return {mNodes.data(), mNodes.size()};
+}
+
+size_t IdsParser::parseInto(std::u32string_view ids, std::vector<IdsNode>& out) {
+    const size_t base = out.size();
+    openNodes.clear();
+    bool approx = false;
+    for(size_t pos = 0; pos < ids.size(); pos++) {
+        char32_t c = ids[pos];
+        if(out.size() > base && openNodes.empty()) {
+            out.resize(base);
+            throw IdsSyntaxError("Too many ingredients in recipe string", pos);
+        }
+        if(c == APPROX_MARKER) {
+            if(approx) {
+                out.resize(base);
+                throw IdsSyntaxError("Repeated approximation marker", pos);
+            }
+            approx = true;
+            continue;
+        }
+        const Operator* op = findOperator(c);
+        if(approx && !op) {
+            out.resize(base);
+            throw IdsSyntaxError("Approximation marker must be followed by an operator", pos);
+        }
+        uint32_t index = out.size() - base;
+        out.push_back({op, c, approx, 0, {0, 0, 0}});
+        approx = false;
+        // the new node is the next ingredient of the innermost operator that still needs ingredients
+        if(!openNodes.empty()) {
+            OpenNode& parent = openNodes.back();
+            IdsNode& parentNode = out[base + parent.node];
+            parentNode.children[parentNode.numChildren++] = index;
+            if(--parent.remaining == 0) {
+                openNodes.pop_back();
+            }
+        }
+        if(op) {
+            openNodes.push_back({index, op->num_ingredients});
+        }
+    }
+    if(approx) {
+        out.resize(base);
+        throw IdsSyntaxError("Approximation marker must be followed by an operator", ids.size());
+    }
+    if(out.size() == base) {
+        throw IdsSyntaxError("Empty recipe string", 0);
+    }
+    if(!openNodes.empty()) {
+        int missing = 0;
+        for(const OpenNode& open : openNodes) {
+            missing += open.remaining;
+        }
+        out.resize(base);
+        throw IdsSyntaxError("Not enough ingredients in recipe string, " + std::to_string(missing) + " more expected", ids.size());
+    }
+    return base;
+}
+
+std::u32string idsToString(IdsTree tree) {
+    std::u32string result;
+    for(size_t i = 0; i < tree.size; i++) {
+        if(tree.nodes[i].approx) {
+            result += APPROX_MARKER;
+        }
+        result += tree.nodes[i].character;
+    }
+    return result;
+}
+
+} // namespace crafting
@@ -0,0 +1,42 @@
+#include "IngredientBuilder.h"
+#include "EmptyIngredient.h"
+
+namespace crafting {
+
+// The first version of every builder.
+static const EmptyIngredient emptyIngredient;
+
+IngredientBuilder::IngredientBuilder()
+    : versions{&emptyIngredient}
+    , current(0)
+{ }
+
+const Ingredient& IngredientBuilder::push(const Ingredient* ingredient) {
+    versions.resize(current + 1);
+    versions.push_back(ingredient);
+    current++;
+    return *ingredient;
+}
+
+bool IngredientBuilder::undo() {
+    if(!canUndo()) {
+        return false;
+    }
+    current--;
+    return true;
+}
+
+bool IngredientBuilder::redo() {
+    if(!canRedo()) {
+        return false;
+    }
+    current++;
+    return true;
+}
+
+void IngredientBuilder::clear() {
+    versions.resize(1);
+    current = 0;
+}
+
+} // namespace crafting
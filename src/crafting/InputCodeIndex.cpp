@@ -0,0 +1,91 @@
+#include "InputCodeIndex.h"
+#include "hashMaps.h"
+#include <algorithm>
+
+namespace crafting {
+
+InputCodeIndex cangjieIndex(DictionaryField::CANGJIE);
+InputCodeIndex fourCornerIndex(DictionaryField::FOUR_CORNER_CODE);
+
+static int groupOf(CharacterId character) {
+    uint8_t frequency = dictionaryData.getFrequency(character);
+    return frequency != 0 ? frequency - 1 : 5;
+}
+
+void InputCodeIndex::build() {
+    entries.clear();
+    for(const Character& character : characterTable) {
+        CharacterId id = character.getId();
+        if(field == DictionaryField::CANGJIE) {
+            uint32_t code = dictionaryData.getCangjie(id);
+            if(code != 0) {
+                entries.push_back({id, code});
+            }
+        }
+        else {
+            for(uint32_t code : dictionaryData.getFourCornerCodes(id)) {
+                entries.push_back({id, code});
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const InputCodeMatch& a, const InputCodeMatch& b) {
+        int groupA = groupOf(a.character);
+        int groupB = groupOf(b.character);
+        if(groupA != groupB) {
+            return groupA < groupB;
+        }
+        return a.code != b.code ? a.code < b.code : a.character < b.character;
+    });
+    groupOffsets.fill(0);
+    for(const InputCodeMatch& entry : entries) {
+        groupOffsets[groupOf(entry.character) + 1]++;
+    }
+    for(int i = 1; i <= NUM_GROUPS; i++) {
+        groupOffsets[i] += groupOffsets[i - 1];
+    }
+}
+
+std::pair<uint32_t, uint32_t> InputCodeIndex::prefixRange(std::string_view prefix) const {
+    return field == DictionaryField::CANGJIE ? cangjiePrefixRange(prefix) : fourCornerPrefixRange(prefix);
+}
+
+std::vector<InputCodeMatch> InputCodeIndex::find(std::string_view prefix, size_t maxResults) const {
+    std::vector<InputCodeMatch> matches;
+    auto [first, last] = prefixRange(prefix);
+    if(first == last) {
+        return matches;
+    }
+    auto codeLess = [](const InputCodeMatch& entry, uint32_t code) { return entry.code < code; };
+    for(int group = 0; group < NUM_GROUPS && matches.size() < maxResults; group++) {
+        auto groupBegin = entries.begin() + groupOffsets[group];
+        auto groupEnd = entries.begin() + groupOffsets[group + 1];
+        auto it = std::lower_bound(groupBegin, groupEnd, first, codeLess);
+        auto end = std::lower_bound(it, groupEnd, last, codeLess);
+        for(; it != end && matches.size() < maxResults; ++it) {
+            // only Four-Corner codes can repeat a character, and only a handful have two codes
+            bool found = std::any_of(matches.begin(), matches.end(), [&](const InputCodeMatch& match) { return match.character == it->character; });
+            if(!found) {
+                matches.push_back(*it);
+            }
+        }
+    }
+    return matches;
+}
+
+size_t InputCodeIndex::count(std::string_view prefix) const {
+    auto [first, last] = prefixRange(prefix);
+    if(first == last) {
+        return 0;
+    }
+    auto codeLess = [](const InputCodeMatch& entry, uint32_t code) { return entry.code < code; };
+    size_t total = 0;
+    for(int group = 0; group < NUM_GROUPS; group++) {
+        auto groupBegin = entries.begin() + groupOffsets[group];
+        auto groupEnd = entries.begin() + groupOffsets[group + 1];
+        auto it = std::lower_bound(groupBegin, groupEnd, first, codeLess);
+        total += std::lower_bound(it, groupEnd, last, codeLess) - it;
+    }
+    return total;
+}
+
+} // namespace crafting
@@ -0,0 +1,61 @@
+#include "LazyMeanings.h"
+#include "hashMaps.h"
+#include "stringUtil.h"
+
+namespace crafting {
+
+LazyMeanings lazyMeanings;
+
+bool LazyMeanings::open(const std::string& path) {
+    offsets.clear();
+    numPending = 0;
+    return file.open(path);
+}
+
+void LazyMeanings::add(CharacterId character, uint32_t offset) {
+    if(offsets.size() <= uint32_t(character)) {
+        offsets.resize(characterTable.size() + 1);
+    }
+    // the details are allocated now, so loading the meanings later only appends to them and never replaces
+    // the details pointer that other threads read without the lock, e.g. through Character::getRecipes
+    characterTable.details(character);
+    numPending += offsets[uint32_t(character)] == 0;
+    offsets[uint32_t(character)] = offset + 1;
+}
+
+std::unique_lock<std::mutex> LazyMeanings::load(CharacterId character) {
+    if(numPending == 0) {
+        return std::unique_lock<std::mutex>();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if(uint32_t(character) < offsets.size() && offsets[uint32_t(character)] != 0) {
+        uint32_t offset = offsets[uint32_t(character)] - 1;
+        offsets[uint32_t(character)] = 0;
+        loadLine(offset);
+        numPending--;
+    }
+    return lock;
+}
+
+void LazyMeanings::loadLine(uint32_t offset) {
+    // e.g. "U+6728\tkDefinition\ttree; wood, lumber; wooden"
+    std::string_view line = file.view().substr(offset);
+    line = line.substr(0, line.find('\n'));
+    if(!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    size_t typeEnd = line.find('\t', line.find('\t') + 1);
+    if(typeEnd == std::string_view::npos) {
+        return;
+    }
+    std::string codePoint(line.substr(0, line.find('\t')));
+    registerMeanings(util::unicodeToChar(codePoint), std::string(line.substr(typeEnd + 1)));
+}
+
+void LazyMeanings::loadAll() {
+    for(size_t id = 0; id < offsets.size() && numPending > 0; id++) {
+        load(CharacterId(id));
+    }
+}
+
+} // namespace crafting
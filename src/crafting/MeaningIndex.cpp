@@ -0,0 +1,231 @@
+#include "MeaningIndex.h"
+#include "hashMaps.h"
+#include "DictionaryData.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+namespace crafting {
+
+MeaningIndex meaningIndex;
+
+// The BM25 parameters: how quickly repeated words stop adding to the score, and how much long meanings are penalized.
+static constexpr float K1 = 1.2f;
+static constexpr float B = 0.75f;
+// How much more the most frequent characters score, each kFrequency step adds a fifth of it.
+static constexpr float FREQUENCY_BOOST = 0.5f;
+
+// Bytes of UTF-8 sequences are part of words, so that words like "café" are kept together.
+static bool isWordByte(char c) {
+    return std::isalnum((unsigned char)c) || (unsigned char)c >= 0x80;
+}
+
+/**
+ * @brief Calls onWord(std::string_view word, bool starred) for every word of the text, before lowercasing.
+ * starred is set if the word is directly followed by a *.
+*/
+template<typename Callback>
+static void forEachWord(std::string_view text, Callback onWord) {
+    size_t i = 0;
+    while(i < text.size()) {
+        if(!isWordByte(text[i])) {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while(i < text.size() && isWordByte(text[i])) {
+            i++;
+        }
+        onWord(text.substr(start, i - start), i < text.size() && text[i] == '*');
+    }
+}
+
+static std::string toLower(std::string_view word) {
+    std::string lower(word);
+    for(char& c : lower) {
+        if(c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+    }
+    return lower;
+}
+
+void MeaningIndex::tokenize(std::string_view text, std::vector<std::string>& out) {
+    out.clear();
+    forEachWord(text, [&](std::string_view word, bool) { out.push_back(toLower(word)); });
+}
+
+void MeaningIndex::build() {
+    size_t numCharacters = characterTable.size() + 1;
+    lengths.assign(numCharacters, 0);
+
+    // words get ids in the order they are first seen, they are renumbered in sorted order afterwards
+    std::unordered_map<std::string, uint32_t> wordIds;
+    std::vector<std::string> unsortedWords;
+    struct Occurrence {
+        uint32_t character;
+        uint32_t word;
+        uint32_t count;
+    };
+    std::vector<Occurrence> occurrences;
+    std::vector<std::string> tokens;
+    std::vector<uint32_t> characterWords;
+    uint64_t totalLength = 0;
+    numDocuments = 0;
+    for(const Character& character : characterTable) {
+        characterWords.clear();
+        for(std::string_view meaning : character.getMeanings()) {
+            tokenize(meaning, tokens);
+            for(std::string& token : tokens) {
+                auto inserted = wordIds.emplace(token, unsortedWords.size());
+                if(inserted.second) {
+                    unsortedWords.push_back(std::move(token));
+                }
+                characterWords.push_back(inserted.first->second);
+            }
+        }
+        if(characterWords.empty()) {
+            continue;
+        }
+        uint32_t id = uint32_t(character.getId());
+        lengths[id] = characterWords.size();
+        totalLength += characterWords.size();
+        numDocuments++;
+        std::sort(characterWords.begin(), characterWords.end());
+        for(size_t i = 0; i < characterWords.size(); ) {
+            size_t j = i;
+            while(j < characterWords.size() && characterWords[j] == characterWords[i]) {
+                j++;
+            }
+            occurrences.push_back({id, characterWords[i], uint32_t(j - i)});
+            i = j;
+        }
+    }
+    averageLength = numDocuments ? float(totalLength) / numDocuments : 0;
+
+    std::vector<uint32_t> order(unsortedWords.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return unsortedWords[a] < unsortedWords[b]; });
+    std::vector<uint32_t> sortedIds(order.size());
+    words.resize(order.size());
+    for(uint32_t i = 0; i < order.size(); i++) {
+        sortedIds[order[i]] = i;
+        words[i] = std::move(unsortedWords[order[i]]);
+    }
+    postings.reset(words.size());
+    for(const Occurrence& occurrence : occurrences) {
+        postings.count(sortedIds[occurrence.word]);
+    }
+    postings.allocate();
+    // occurrences are in character order, so every posting list is sorted by character id
+    for(const Occurrence& occurrence : occurrences) {
+        postings.add(sortedIds[occurrence.word], {CharacterId(occurrence.character), occurrence.count});
+    }
+}
+
+std::pair<size_t, size_t> MeaningIndex::findWords(std::string_view word, bool prefix) const {
+    auto first = std::lower_bound(words.begin(), words.end(), word);
+    auto last = first;
+    if(prefix) {
+        // the words starting with the prefix directly follow it in sorted order
+        last = std::partition_point(first, words.end(), [&](const std::string& other) { return other.compare(0, word.size(), word) == 0; });
+    }
+    else if(last != words.end() && *last == word) {
+        ++last;
+    }
+    return {size_t(first - words.begin()), size_t(last - words.begin())};
+}
+
+void MeaningIndex::scoreWord(std::string_view word, bool prefix, std::vector<MeaningMatch>& out) const {
+    out.clear();
+    auto [first, last] = findWords(word, prefix);
+    for(size_t i = first; i < last; i++) {
+        util::ArrayView<Posting> list = postings[i];
+        float idf = std::log(1 + (numDocuments - list.size() + 0.5f) / (list.size() + 0.5f));
+        for(const Posting& posting : list) {
+            float count = posting.count;
+            float norm = K1 * (1 - B + B * lengths[uint32_t(posting.character)] / averageLength);
+            out.push_back({posting.character, idf * count * (K1 + 1) / (count + norm)});
+        }
+    }
+    if(last - first > 1) {
+        // a character matching several words of a prefix counts with its best one
+        std::sort(out.begin(), out.end(), [](const MeaningMatch& a, const MeaningMatch& b) { return a.character < b.character; });
+        size_t merged = 0;
+        for(size_t i = 1; i < out.size(); i++) {
+            if(out[i].character == out[merged].character) {
+                out[merged].score = std::max(out[merged].score, out[i].score);
+            }
+            else {
+                out[++merged] = out[i];
+            }
+        }
+        out.resize(std::min(out.size(), merged + 1));
+    }
+}
+
+std::vector<MeaningMatch> MeaningIndex::search(std::string_view text, const MeaningQuery& query) const {
+    std::vector<std::pair<std::string, bool>> queryWords;
+    forEachWord(text, [&](std::string_view word, bool starred) { queryWords.push_back({toLower(word), starred}); });
+    if(queryWords.empty()) {
+        return {};
+    }
+    if(query.prefixLastWord && isWordByte(text.back())) {
+        queryWords.back().second = true; // the last word is still being typed
+    }
+
+    std::vector<MeaningMatch> matches;
+    std::vector<MeaningMatch> wordMatches;
+    std::vector<MeaningMatch> combined;
+    for(size_t w = 0; w < queryWords.size(); w++) {
+        scoreWord(queryWords[w].first, queryWords[w].second, wordMatches);
+        if(w == 0) {
+            matches.swap(wordMatches);
+            continue;
+        }
+        // both lists are sorted by character id, so they are merged in one pass
+        combined.clear();
+        size_t i = 0;
+        size_t j = 0;
+        while(i < matches.size() || j < wordMatches.size()) {
+            if(j == wordMatches.size() || (i < matches.size() && matches[i].character < wordMatches[j].character)) {
+                if(!query.matchAll) {
+                    combined.push_back(matches[i]);
+                }
+                i++;
+            }
+            else if(i == matches.size() || wordMatches[j].character < matches[i].character) {
+                if(!query.matchAll) {
+                    combined.push_back(wordMatches[j]);
+                }
+                j++;
+            }
+            else {
+                combined.push_back({matches[i].character, matches[i].score + wordMatches[j].score});
+                i++;
+                j++;
+            }
+        }
+        matches.swap(combined);
+    }
+
+    if(query.boostFrequent) {
+        for(MeaningMatch& match : matches) {
+            uint8_t frequency = dictionaryData.getFrequency(match.character);
+            if(frequency != 0) {
+                match.score *= 1 + FREQUENCY_BOOST * (6 - frequency) / 5;
+            }
+        }
+    }
+    auto better = [](const MeaningMatch& a, const MeaningMatch& b) {
+        return a.score != b.score ? a.score > b.score : a.character < b.character;
+    };
+    size_t numResults = std::min(query.maxResults, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + numResults, matches.end(), better);
+    matches.resize(numResults);
+    return matches;
+}
+
+} // namespace crafting
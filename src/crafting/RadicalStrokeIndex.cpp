@@ -0,0 +1,88 @@
+#include "RadicalStrokeIndex.h"
+#include "hashMaps.h"
+#include <algorithm>
+
+namespace crafting {
+
+RadicalStrokeIndex radicalStrokeIndex;
+
+bool RadicalStrokeIndex::add(CharacterId character, uint8_t radical, uint8_t radicalStrokes, uint8_t residualStrokes) {
+    if(radical == 0 || radical > NUM_RADICALS || radicalStrokes + residualStrokes > MAX_STROKES) {
+        return false;
+    }
+    if(entries.size() <= uint32_t(character)) {
+        entries.resize(characterTable.size() + 1);
+    }
+    RadicalStrokes& entry = entries[uint32_t(character)];
+    if(entry.radical != 0) {
+        return false;
+    }
+    entry = {radical, radicalStrokes, residualStrokes, uint8_t(radicalStrokes + residualStrokes)};
+    return true;
+}
+
+void RadicalStrokeIndex::build() {
+    entries.resize(characterTable.size() + 1);
+    // both indexes are filled by counting sort, going through the characters in id order keeps equal keys sorted by id
+    radicalOffsets.assign(NUM_RADICALS + 2, 0);
+    strokeOffsets.assign(MAX_STROKES + 2, 0);
+    for(const RadicalStrokes& entry : entries) {
+        if(entry.radical != 0) {
+            radicalOffsets[entry.radical + 1]++;
+            strokeOffsets[entry.totalStrokes + 1]++;
+        }
+    }
+    for(size_t i = 1; i < radicalOffsets.size(); i++) {
+        radicalOffsets[i] += radicalOffsets[i - 1];
+    }
+    for(size_t i = 1; i < strokeOffsets.size(); i++) {
+        strokeOffsets[i] += strokeOffsets[i - 1];
+    }
+    byRadical.resize(radicalOffsets.back());
+    byStrokes.resize(strokeOffsets.back());
+    std::vector<uint32_t> radicalPositions(radicalOffsets.begin(), radicalOffsets.end() - 1);
+    std::vector<uint32_t> strokePositions(strokeOffsets.begin(), strokeOffsets.end() - 1);
+    for(uint32_t id = 0; id < entries.size(); id++) {
+        if(entries[id].radical != 0) {
+            byRadical[radicalPositions[entries[id].radical]++] = CharacterId(id);
+            byStrokes[strokePositions[entries[id].totalStrokes]++] = CharacterId(id);
+        }
+    }
+    for(int radical = 1; radical <= NUM_RADICALS; radical++) {
+        std::stable_sort(byRadical.begin() + radicalOffsets[radical], byRadical.begin() + radicalOffsets[radical + 1],
+            [&](CharacterId a, CharacterId b) { return entries[uint32_t(a)].residualStrokes < entries[uint32_t(b)].residualStrokes; });
+    }
+}
+
+util::ArrayView<CharacterId> RadicalStrokeIndex::getByRadical(int radical, int minResidualStrokes, int maxResidualStrokes) const {
+    if(radical < 1 || radical > NUM_RADICALS || radicalOffsets.empty() || minResidualStrokes > maxResidualStrokes) {
+        return {};
+    }
+    auto first = byRadical.begin() + radicalOffsets[radical];
+    auto last = byRadical.begin() + radicalOffsets[radical + 1];
+    first = std::lower_bound(first, last, minResidualStrokes,
+        [&](CharacterId character, int strokes) { return entries[uint32_t(character)].residualStrokes < strokes; });
+    last = std::upper_bound(first, last, maxResidualStrokes,
+        [&](int strokes, CharacterId character) { return strokes < entries[uint32_t(character)].residualStrokes; });
+    return {byRadical.data() + (first - byRadical.begin()), size_t(last - first)};
+}
+
+util::ArrayView<CharacterId> RadicalStrokeIndex::getByStrokes(int minStrokes, int maxStrokes) const {
+    minStrokes = std::max(minStrokes, 0);
+    maxStrokes = std::min(maxStrokes, MAX_STROKES);
+    if(strokeOffsets.empty() || minStrokes > maxStrokes) {
+        return {};
+    }
+    return {byStrokes.data() + strokeOffsets[minStrokes], strokeOffsets[maxStrokes + 1] - strokeOffsets[minStrokes]};
+}
+
+void RadicalStrokeIndex::sortByStrokes(std::vector<CharacterId>& characters) const {
+    std::stable_sort(characters.begin(), characters.end(), [&](CharacterId a, CharacterId b) {
+        RadicalStrokes dataA = get(a);
+        RadicalStrokes dataB = get(b);
+        // characters without data have radical 0 and are sorted behind all others
+        return (dataA.radical == 0 ? MAX_STROKES + 1 : dataA.totalStrokes) < (dataB.radical == 0 ? MAX_STROKES + 1 : dataB.totalStrokes);
+    });
+}
+
+} // namespace crafting
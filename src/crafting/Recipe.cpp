@@ -2,162 +2,120 @@
 #include "Character.h"
 #include "stringUtil.h"
 #include "hashMaps.h"
+#include "RecipeInterner.h"
 #include <iostream>
+#include <algorithm>
 
 namespace crafting {
 
-std::unordered_map<char32_t, Operator> operators{
-    {U'↔', {U'↔', 1, true}},
-    {U'↷', {U'↷', 1, true}},
-    {U'⊖', {U'⊖', 2, true}},
-    {U'⿰', {U'⿰', 2, true}},
-    {U'⿱', {U'⿱', 2, true}},
-    {U'⿲', {U'⿲', 3, true}},
-    {U'⿳', {U'⿳', 3, true}},
-    {U'⿴', {U'⿴', 2, true}},
-    {U'⿵', {U'⿵', 2, true}},
-    {U'⿶', {U'⿶', 2, true}},
-    {U'⿷', {U'⿷', 2, true}},
-    {U'⿸', {U'⿸', 2, true}},
-    {U'⿹', {U'⿹', 2, true}},
-    {U'⿺', {U'⿺', 2, true}},
-    {U'⿻', {U'⿻', 2, false}}
-};
-
-Recipe::Recipe(char32_t op, std::initializer_list<std::shared_ptr<Ingredient>> ingredients) 
-    : mIngredients(ingredients) 
-    , mOperator(operators[op])
-{
-    if(!mOperator) {
+/**
+ * @brief Gets the operator for a constructor's initializer list.
+ * @throws std::runtime_error If the character does not represent an operator.
+*/
+static const Operator& requireOperator(char32_t op) {
+    const Operator* result = findOperator(op);
+    if(!result) {
         throw std::runtime_error("Invalid operator character.");
     }
-    if(mIngredients.size() != mOperator.num_ingredients) {
-        throw std::runtime_error("Number of ingredients does not match operator: " + std::to_string(mOperator.num_ingredients) + " expected, but " + std::to_string(ingredients.size()) + " given.");
-    }
-    Ingredient* firstIng = mIngredients[0].get();
-    if(Character* firstChar = dynamic_cast<Character*>(firstIng)) {
-        firstChar->setPlacementFlag(mOperator.operator_c, true);
+    return *result;
+}
+
+/**
+ * @brief Gets the operator of the root of a parsed recipe string for a constructor's initializer list.
+ * @throws std::runtime_error If the root is not an operator.
+*/
+static const Operator& requireRootOperator(IdsTree tree) {
+    if(!tree.root().op) {
+        throw std::runtime_error("First character of recipe string must be an operator, but instead is " + util::u32_to_u8(std::u32string(1, tree.root().character)));
     }
+    return *tree.root().op;
 }
 
-Recipe::Recipe(char32_t op, const std::vector<std::shared_ptr<Ingredient>>& ingredients) 
-    : mIngredients(ingredients)
-    , mOperator(operators[op])
+// Parser for recipe strings, one per thread since the parsed nodes are only valid until the next parse.
+static thread_local IdsParser recipeParser;
+
+Recipe::Recipe(char32_t op, IngredientList ingredients, bool approx) 
+    : Ingredient(IngredientKind::RECIPE)
+    , mIngredients{nullptr, nullptr, nullptr}
+    , mNumIngredients(ingredients.size())
+    , mOperator(requireOperator(op))
+    , approx(approx)
 {
-    if(!mOperator) {
-        throw std::runtime_error("Invalid operator character.");
-    }
-    if(mIngredients.size() != mOperator.num_ingredients) {
+    if(ingredients.size() != size_t(mOperator.num_ingredients)) {
         throw std::runtime_error("Number of ingredients does not match operator: " + std::to_string(mOperator.num_ingredients) + " expected, but " + std::to_string(ingredients.size()) + " given.");
     }
-    Ingredient* firstIng = mIngredients[0].get();
-    if(Character* firstChar = dynamic_cast<Character*>(firstIng)) {
-        firstChar->setPlacementFlag(mOperator.operator_c, true);
+    std::copy(ingredients.begin(), ingredients.end(), mIngredients);
+    if(mIngredients[0]->getKind() == IngredientKind::CHARACTER) {
+        characterTable[static_cast<const Character*>(mIngredients[0])->getId()].setPlacementFlag(mOperator.operator_c, true);
     }
+    assignId();
 }
 
-static int findRecipeSubstrLength(const std::u32string& recipeString, int startPos) {
-    //std::cout << "Finding recipe substr length for " << util::u32_to_u8(recipeString) << " at " << startPos << std::endl;
-    Operator& op = operators[recipeString[startPos]];
-    //std::cout << "Found operator " << op.operator_c << " with " << op.num_ingredients << " ingredients" << std::endl;
-    int pos = startPos + 1;
-    for(int i = 0; i < op.num_ingredients; i++) {
-        if(operators[recipeString[pos]]) {
-            pos += findRecipeSubstrLength(recipeString, pos);
-        }
-        else {
-            pos++;
-        }
-    }
-    //std::cout << "Found recipe substr length for " << util::u32_to_u8(recipeString) << " at " << startPos << " to be " << pos - startPos << std::endl;
-    return pos - startPos;
-}
+Recipe::Recipe(std::u32string_view recipeString) 
+    : Recipe(recipeParser.parse(recipeString))
+{ }
 
-Recipe::Recipe(std::u32string recipeString) 
-    : mIngredients()
-    , mOperator(recipeString[0] == U'〾' ? operators[recipeString[1]] : operators[recipeString[0]])
-    , approx(recipeString[0] == U'〾')
+Recipe::Recipe(IdsTree tree)
+    : Ingredient(IngredientKind::RECIPE)
+    , mIngredients{nullptr, nullptr, nullptr}
+    , mNumIngredients(tree.root().numChildren)
+    , mOperator(requireRootOperator(tree))
+    , approx(tree.root().approx)
 {
-    if(approx) {
-        recipeString = recipeString.substr(1);
-    }
-    const char32_t* charPtr = recipeString.data();
-    if (!operators[*charPtr]) {
-        throw std::runtime_error("First character of recipe string must be an operator, but instead is " + util::u32_to_u8(std::u32string(1, *charPtr)));
-    }
-    charPtr++;
-    int pos = 1;
-    for(int i = 0; i < mOperator.num_ingredients; i++) {
-        if(pos >= recipeString.size()) {
-            throw std::runtime_error("Not enough ingredients in recipe string.");// Debug info: currently constructung " + util::u32_to_u8(recipeString) + ". Pos is at " + std::to_string(pos) + " and recipeString.size() is " + std::to_string(recipeString.size()) + ". i is at " + std::to_string(i) + ".");
+    // Characters are looked up in the order they appear in, then sub-recipes are built bottom-up as shared, interned nodes.
+    // Pre-order guarantees that every node's children come after it, so walking backwards builds children first.
+    thread_local std::vector<const Ingredient*> built;
+    built.resize(tree.size);
+    for(size_t i = 1; i < tree.size; i++) {
+        if(!tree.nodes[i].op) {
+            built[i] = &characterTable[characterTable.getId(tree.nodes[i].character)];
         }
-        else if(operators[*charPtr]) {
-            int len = findRecipeSubstrLength(recipeString, pos);
-            if(pos + len > recipeString.size()) {
-                throw std::runtime_error("Not enough ingredients in recipe string. Pos is at " + std::to_string(pos) + " and recipeString.size() is " + std::to_string(recipeString.size()) + ". i is at " + std::to_string(i) + ". len is at " + std::to_string(len) + ". While constructing " + util::u32_to_u8(recipeString) + ".");
+    }
+    std::vector<const Ingredient*> ingredients;
+    for(size_t i = tree.size - 1; i > 0; i--) {
+        const IdsNode& node = tree.nodes[i];
+        if(node.op) {
+            ingredients.clear();
+            for(int j = 0; j < node.numChildren; j++) {
+                ingredients.push_back(built[node.children[j]]);
             }
-            mIngredients.emplace_back(new Recipe(recipeString.substr(pos, len)));
-            pos += len;
-            charPtr += len;
-        }
-        else {
-            mIngredients.emplace_back(crafting::getCharacter(*charPtr));
-            charPtr++;
-            pos++;
+            built[i] = recipeInterner.intern(node.character, ingredients, node.approx);
         }
     }
-    Ingredient* firstIng = mIngredients[0].get();
-    if(Character* firstChar = dynamic_cast<Character*>(firstIng)) {
-        firstChar->setPlacementFlag(mOperator.operator_c, true);
+    for(int j = 0; j < tree.root().numChildren; j++) {
+        mIngredients[j] = built[tree.root().children[j]];
     }
-    if(pos < recipeString.size()) {
-        throw std::runtime_error("Too many ingredients in recipe string. Pos is at " + std::to_string(pos) + " and recipeString.size() is " + std::to_string(recipeString.size()));
+    built.clear();
+    if(mIngredients[0]->getKind() == IngredientKind::CHARACTER) {
+        characterTable[static_cast<const Character*>(mIngredients[0])->getId()].setPlacementFlag(mOperator.operator_c, true);
     }
+    assignId();
 }
 
 bool Recipe::operator==(const Ingredient& other) const {
-    const Recipe* otherRecipe = dynamic_cast<const Recipe*>(&other);
-    if(otherRecipe == nullptr) {
+    if(other.getKind() != IngredientKind::RECIPE) {
         return false;
     }
     else {
-        return *this == *otherRecipe;
+        return *this == static_cast<const Recipe&>(other);
     }
 }
 
 bool Recipe::operator==(const Recipe& other) const {
-    if(mOperator.operator_c != other.getOperator().operator_c
-            || approx != other.getApprox()) {
-        return false;
-    }
-    else {
-        if(mIngredients.size() != other.getIngredients().size()) {
-            return false;
-        }
-        else if(mOperator.ordered) {
-            for(int i = 0; i < mIngredients.size(); i++) {
-                if(!(*mIngredients[i] == *other.getIngredients()[i])) {
-                    return false;
-                }
-            }
-            return true;
-        }
-        else {
-            for(int i = 0; i < mIngredients.size(); i++) {
-                bool found = false;
-                for(int j = 0; j < other.getIngredients().size(); j++) {
-                    if(*mIngredients[i] == *other.getIngredients()[j]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if(!found) {
-                    return false;
-                }
-            }
-            return true;
-        }
+    return mCanonicalId == other.mCanonicalId;
+}
+
+const Recipe* Recipe::interned() const {
+    if(recipeInterner.getRecipe(mId) == this) {
+        return this; // already the shared node, no need to look it up again
     }
+    return recipeInterner.intern(mOperator.operator_c, getIngredients(), approx);
+}
+
+void Recipe::assignId() {
+    mId = recipeInterner.getId(makeRecipeKey(mOperator.operator_c, approx, getIngredients()));
+    mCanonicalId = recipeInterner.getCanonicalId(mId);
+    mHash = recipeInterner.getCanonicalHash(mCanonicalId);
 }
 
 Recipe::operator std::u32string() const {
@@ -166,111 +124,83 @@ Recipe::operator std::u32string() const {
         recipeString += U'〾';
     }
     recipeString += mOperator.operator_c;
-    for(int i = 0; i < mIngredients.size(); i++) {
+    for(int i = 0; i < mNumIngredients; i++) {
         recipeString += std::u32string(*mIngredients[i]);
     }
     return recipeString;
 }
 
-std::shared_ptr<Ingredient> Recipe::addLeft(std::shared_ptr<Character> character) {
+const Ingredient* Recipe::addLeft(CharacterId character) const {
     if(mOperator.operator_c == U'⿰') {
-        return std::make_shared<Recipe>(U'⿲',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(character),
-                                            mIngredients[0],
-                                            mIngredients[1]
-                                        });
+        const Ingredient* ingredients[] = {&characterTable[character], mIngredients[0], mIngredients[1]};
+        return recipeInterner.intern(U'⿲', ingredients);
     }
     else {
-        return std::make_shared<Recipe>(U'⿰',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(character),
-                                            std::dynamic_pointer_cast<Ingredient>(shared_from_this())
-                                        });
+        const Ingredient* ingredients[] = {&characterTable[character], interned()};
+        return recipeInterner.intern(U'⿰', ingredients);
     }
 }
 
-std::shared_ptr<Ingredient> Recipe::addRight(std::shared_ptr<Character> character) {
+const Ingredient* Recipe::addRight(CharacterId character) const {
     if(mOperator.operator_c == U'⿰') {
-        return std::make_shared<Recipe>(U'⿲',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            mIngredients[0],
-                                            mIngredients[1],
-                                            std::dynamic_pointer_cast<Ingredient>(character)
-                                        });
+        const Ingredient* ingredients[] = {mIngredients[0], mIngredients[1], &characterTable[character]};
+        return recipeInterner.intern(U'⿲', ingredients);
     }
     else {
-        return std::make_shared<Recipe>(U'⿰',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(shared_from_this()),
-                                            std::dynamic_pointer_cast<Ingredient>(character)
-                                        });
+        const Ingredient* ingredients[] = {interned(), &characterTable[character]};
+        return recipeInterner.intern(U'⿰', ingredients);
     }
 }
 
-std::shared_ptr<Ingredient> Recipe::addAbove(std::shared_ptr<Character> character) {
+const Ingredient* Recipe::addAbove(CharacterId character) const {
     if(mOperator.operator_c == U'⿱') {
-        return std::make_shared<Recipe>(U'⿳',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(character),
-                                            mIngredients[0],
-                                            mIngredients[1]
-                                        });
+        const Ingredient* ingredients[] = {&characterTable[character], mIngredients[0], mIngredients[1]};
+        return recipeInterner.intern(U'⿳', ingredients);
     }
     else {
-        return std::make_shared<Recipe>(U'⿱',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(character),
-                                            std::dynamic_pointer_cast<Ingredient>(shared_from_this())
-                                        });
+        const Ingredient* ingredients[] = {&characterTable[character], interned()};
+        return recipeInterner.intern(U'⿱', ingredients);
     }
 }
 
-std::shared_ptr<Ingredient> Recipe::addBelow(std::shared_ptr<Character> character) {
+const Ingredient* Recipe::addBelow(CharacterId character) const {
     if(mOperator.operator_c == U'⿱') {
-        return std::make_shared<Recipe>(U'⿳',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            mIngredients[0],
-                                            mIngredients[1],
-                                            std::dynamic_pointer_cast<Ingredient>(character)
-                                        });
+        const Ingredient* ingredients[] = {mIngredients[0], mIngredients[1], &characterTable[character]};
+        return recipeInterner.intern(U'⿳', ingredients);
     }
     else {
-        return std::make_shared<Recipe>(U'⿱',
-                                        std::vector<std::shared_ptr<Ingredient>>{
-                                            std::dynamic_pointer_cast<Ingredient>(shared_from_this()),
-                                            std::dynamic_pointer_cast<Ingredient>(character)
-                                        });
+        const Ingredient* ingredients[] = {interned(), &characterTable[character]};
+        return recipeInterner.intern(U'⿱', ingredients);
     }
 }
 
-rendering::GreyBitmap Recipe::render(int width, int height) const {
+rendering::GreyBitmap Recipe::render(int width, int height, Region region) const {
     switch(mOperator.operator_c) {
-        case U'↔': return mIngredients[0]->render(width, height).mirror();
-        case U'↷': return mIngredients[0]->render(width, height).rotate180();
+        case U'↔': return mIngredients[0]->render(width, height, region).mirror();
+        case U'↷': return mIngredients[0]->render(width, height, region).rotate180();
         case U'⊖': return rendering::GreyBitmap(width, height); // not intended to be rendered
-		case U'⿰': return mIngredients[0]->render(width/2 + ((width%2) ? 1 : 0), height).joinHorizontally(mIngredients[1]->render(width/2, height));
-		case U'⿱': return mIngredients[0]->render(width, height/2 + ((height%2) ? 1 : 0)).joinVertically(mIngredients[1]->render(width, height/2));
+		case U'⿰': return mIngredients[0]->render(width/2 + ((width%2) ? 1 : 0), height, region).joinHorizontally(mIngredients[1]->render(width/2, height, region));
+		case U'⿱': return mIngredients[0]->render(width, height/2 + ((height%2) ? 1 : 0), region).joinVertically(mIngredients[1]->render(width, height/2, region));
 		case U'⿲': {
 			int rest = width % 3;
-			return mIngredients[0]->render(width/3 + (rest ? 1 : 0), height).joinHorizontally(
-				   mIngredients[1]->render(width/3 + ((rest==2) ? 1 : 0), height).joinHorizontally(
-				   mIngredients[2]->render(width/3, height)));
+			return mIngredients[0]->render(width/3 + (rest ? 1 : 0), height, region).joinHorizontally(
+				   mIngredients[1]->render(width/3 + ((rest==2) ? 1 : 0), height, region).joinHorizontally(
+				   mIngredients[2]->render(width/3, height, region)));
 		}
         case U'⿳': {
             int rest = height % 3;
-			return mIngredients[0]->render(width, height/3 + (rest ? 1 : 0)).joinVertically(
-				   mIngredients[1]->render(width, height/3 + ((rest==2) ? 1 : 0)).joinVertically(
-				   mIngredients[2]->render(width, height/3)));
+			return mIngredients[0]->render(width, height/3 + (rest ? 1 : 0), region).joinVertically(
+				   mIngredients[1]->render(width, height/3 + ((rest==2) ? 1 : 0), region).joinVertically(
+				   mIngredients[2]->render(width, height/3, region)));
         }
-        case U'⿴': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width/2, height/2).placeOnCanvas(width, height));
-        case U'⿵': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width/3, height*2/3).placeOnCanvas(width, height, width/3, height/3));
-        case U'⿶': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width/3, height*2/3).placeOnCanvas(width, height, width/3, 0));
-        case U'⿷': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width*2/3, height/3).placeOnCanvas(width, height, width/3, height/3)); 
-        case U'⿸': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width*2/3, height*2/3).placeOnCanvas(width, height, width/3, height/3));
-        case U'⿹': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width*2/3, height*2/3).placeOnCanvas(width, height, 0, height/3));
-        case U'⿺': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width*2/3, height*2/3).placeOnCanvas(width, height, width/3, 0));
-        case U'⿻': return mIngredients[0]->render(width, height).overlay(mIngredients[1]->render(width, height));
+        case U'⿴': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width/2, height/2, region).placeOnCanvas(width, height));
+        case U'⿵': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width/3, height*2/3, region).placeOnCanvas(width, height, width/3, height/3));
+        case U'⿶': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width/3, height*2/3, region).placeOnCanvas(width, height, width/3, 0));
+        case U'⿷': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width*2/3, height/3, region).placeOnCanvas(width, height, width/3, height/3)); 
+        case U'⿸': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width*2/3, height*2/3, region).placeOnCanvas(width, height, width/3, height/3));
+        case U'⿹': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width*2/3, height*2/3, region).placeOnCanvas(width, height, 0, height/3));
+        case U'⿺': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width*2/3, height*2/3, region).placeOnCanvas(width, height, width/3, 0));
+        case U'⿻': return mIngredients[0]->render(width, height, region).overlay(mIngredients[1]->render(width, height, region));
         default: return rendering::GreyBitmap(width, height);
     }
 }
@@ -279,11 +209,6 @@ rendering::GreyBitmap Recipe::render(int width, int height) const {
 
 namespace std {
     size_t hash<crafting::Recipe>::operator()(const crafting::Recipe& recipe) const {
-        u32string recipeString(recipe);
-        size_t hash = 0;
-        for(char32_t c : recipeString) {
-            hash ^= c;
-        }
-        return hash;
+        return recipe.getHash();
     }
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "RecipeInterner.h"
+#include "Recipe.h"
+#include "Character.h"
+#include "Operator.h"
+#include "byteUtil.h"
+#include <algorithm>
+#include <iterator>
+
+namespace crafting {
+
+RecipeInterner recipeInterner;
+
+bool RecipeKey::operator==(const RecipeKey& other) const {
+    if(op != other.op || approx != other.approx || numIngredients != other.numIngredients) {
+        return false;
+    }
+    for(int i = 0; i < numIngredients; i++) {
+        if(ingredients[i] != other.ingredients[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t RecipeKey::hash() const {
+    uint64_t result = util::hashCombine(op, approx);
+    for(int i = 0; i < numIngredients; i++) {
+        result = util::hashCombine(result, ingredients[i]);
+    }
+    return result;
+}
+
+RecipeKey makeRecipeKey(char32_t op, bool approx, IngredientList ingredients) {
+    RecipeKey key{op, approx, (uint8_t)ingredients.size(), {0, 0, 0}};
+    for(size_t i = 0; i < ingredients.size() && i < 3; i++) {
+        const Ingredient* ingredient = ingredients[i];
+        switch(ingredient->getKind()) {
+            case IngredientKind::CHARACTER:
+                key.ingredients[i] = static_cast<const Character*>(ingredient)->getCharacter();
+                break;
+            case IngredientKind::RECIPE:
+                key.ingredients[i] = static_cast<const Recipe*>(ingredient)->getId() | RecipeKey::RECIPE_BIT;
+                break;
+            default:
+                break;
+        }
+    }
+    return key;
+}
+
+// The indexes are grown when more than half of their slots are used.
+static constexpr size_t MIN_INDEX_SIZE = 1024;
+
+/**
+ * @brief Finds the slot of an index holding the id of the given key, or the empty slot it would be put into.
+ * @param keys The keys by id.
+*/
+static size_t findSlot(const std::vector<uint32_t>& index, const std::vector<RecipeKey>& keys, const RecipeKey& key, uint64_t hash) {
+    size_t mask = index.size() - 1;
+    for(size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        if(index[slot] == 0 || keys[index[slot]] == key) {
+            return slot;
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds an index with more slots if it can not hold the given number of ids.
+ * @param getHash Gets the hash of the key with the given id.
+*/
+template<typename GetHash>
+static void reserveIndex(std::vector<uint32_t>& index, const std::vector<RecipeKey>& keys, size_t numIds, GetHash getHash) {
+    if(numIds * 2 <= index.size()) {
+        return;
+    }
+    size_t numSlots = std::max(index.size(), MIN_INDEX_SIZE);
+    while(numIds * 2 > numSlots) {
+        numSlots *= 2;
+    }
+    index.assign(numSlots, 0);
+    for(uint32_t id = 1; id < keys.size(); id++) {
+        index[findSlot(index, keys, keys[id], getHash(id))] = id;
+    }
+}
+
+uint32_t RecipeInterner::getId(const RecipeKey& key) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    reserveIndex(idIndex, keys, keys.size(), [this](uint32_t id) { return keys[id].hash(); });
+    uint32_t& slot = idIndex[findSlot(idIndex, keys, key, key.hash())];
+    if(slot != 0) {
+        return slot;
+    }
+    slot = keys.size();
+    keys.push_back(key);
+    nodes.push_back(nullptr);
+    canonicalIds.push_back(canonicalize(key));
+    return slot;
+}
+
+/**
+ * @brief Gets the operator that a binary operator is flattened into, or 0 if it is not flattened.
+*/
+static char32_t flattenedOperator(char32_t op) {
+    switch(op) {
+        case U'⿰': return U'⿲';
+        case U'⿱': return U'⿳';
+        default: return 0;
+    }
+}
+
+uint32_t RecipeInterner::canonicalize(const RecipeKey& key) {
+    RecipeKey canonical = key;
+    for(int i = 0; i < canonical.numIngredients; i++) {
+        if(canonical.ingredients[i] & RecipeKey::RECIPE_BIT) {
+            canonical.ingredients[i] = canonicalIds[canonical.ingredients[i] & ~RecipeKey::RECIPE_BIT] | RecipeKey::RECIPE_BIT;
+        }
+    }
+    return internCanonical(canonical);
+}
+
+RecipeKey RecipeInterner::makeCanonical(RecipeKey canonical) const {
+    char32_t flatOp = flattenedOperator(canonical.op);
+    if(flatOp && !canonical.approx && canonical.numIngredients == 2) {
+        // an ingredient that is the same binary operator can be merged into a ternary one, but only if exactly one of them is
+        auto isFlattenable = [&](uint64_t ingredient) {
+            if(!(ingredient & RecipeKey::RECIPE_BIT)) {
+                return false;
+            }
+            const RecipeKey& inner = canonicalKeys[ingredient & ~RecipeKey::RECIPE_BIT];
+            return inner.op == canonical.op && !inner.approx && inner.numIngredients == 2;
+        };
+        bool flattenFirst = isFlattenable(canonical.ingredients[0]);
+        bool flattenSecond = isFlattenable(canonical.ingredients[1]);
+        if(flattenFirst != flattenSecond) {
+            uint64_t first = canonical.ingredients[0];
+            uint64_t second = canonical.ingredients[1];
+            if(flattenFirst) {
+                const RecipeKey& inner = canonicalKeys[first & ~RecipeKey::RECIPE_BIT];
+                canonical.ingredients[0] = inner.ingredients[0];
+                canonical.ingredients[1] = inner.ingredients[1];
+                canonical.ingredients[2] = second;
+            }
+            else {
+                const RecipeKey& inner = canonicalKeys[second & ~RecipeKey::RECIPE_BIT];
+                canonical.ingredients[0] = first;
+                canonical.ingredients[1] = inner.ingredients[0];
+                canonical.ingredients[2] = inner.ingredients[1];
+            }
+            canonical.op = flatOp;
+            canonical.numIngredients = 3;
+        }
+    }
+    const Operator* op = findOperator(canonical.op);
+    if(op && !op->ordered) {
+        // the order of the ingredients does not matter for crafting, so every permutation gets the same canonical key,
+        // numIngredients is bounded explicitly since the compiler can not tell that it never exceeds the array
+        size_t numIngredients = std::min<size_t>(canonical.numIngredients, std::size(canonical.ingredients));
+        std::sort(canonical.ingredients, canonical.ingredients + numIngredients);
+    }
+    return canonical;
+}
+
+uint32_t RecipeInterner::internCanonical(const RecipeKey& key) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    RecipeKey canonical = makeCanonical(key);
+    reserveIndex(canonicalIndex, canonicalKeys, canonicalKeys.size(), [this](uint32_t id) { return canonicalHashes[id]; });
+    uint64_t hash = canonical.hash();
+    uint32_t& slot = canonicalIndex[findSlot(canonicalIndex, canonicalKeys, canonical, hash)];
+    if(slot == 0) {
+        slot = canonicalKeys.size();
+        canonicalKeys.push_back(canonical);
+        canonicalHashes.push_back(hash);
+    }
+    return slot;
+}
+
+uint32_t RecipeInterner::findCanonical(const RecipeKey& key) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if(canonicalIndex.empty()) {
+        return 0;
+    }
+    RecipeKey canonical = makeCanonical(key);
+    return canonicalIndex[findSlot(canonicalIndex, canonicalKeys, canonical, canonical.hash())];
+}
+
+const Recipe* RecipeInterner::intern(char32_t op, IngredientList ingredients, bool approx) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    const Operator* recipeOperator = findOperator(op);
+    if(recipeOperator && size_t(recipeOperator->num_ingredients) == ingredients.size()) {
+        RecipeKey key = makeRecipeKey(op, approx, ingredients);
+        uint32_t id = idIndex.empty() ? 0 : idIndex[findSlot(idIndex, keys, key, key.hash())];
+        if(nodes[id]) {
+            return nodes[id];
+        }
+    }
+    // constructing validates the recipe and assigns its id
+    const Recipe* node = arena.create(op, ingredients, approx);
+    nodes[node->getId()] = node;
+    return node;
+}
+
+void RecipeInterner::reserve(size_t numRecipes) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    keys.reserve(numRecipes + 1);
+    nodes.reserve(numRecipes + 1);
+    canonicalIds.reserve(numRecipes + 1);
+    canonicalKeys.reserve(numRecipes + 1);
+    canonicalHashes.reserve(numRecipes + 1);
+    reserveIndex(idIndex, keys, numRecipes + 1, [this](uint32_t id) { return keys[id].hash(); });
+    reserveIndex(canonicalIndex, canonicalKeys, numRecipes + 1, [this](uint32_t id) { return canonicalHashes[id]; });
+}
+
+void RecipeInterner::clear() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    keys.assign(1, RecipeKey{});
+    idIndex.clear();
+    nodes.assign(1, nullptr);
+    canonicalIds.assign(1, 0);
+    canonicalKeys.assign(1, RecipeKey{});
+    canonicalHashes.assign(1, 0);
+    arena.clear();
+}
+
+} // namespace crafting
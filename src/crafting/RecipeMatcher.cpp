@@ -0,0 +1,268 @@
+#include "RecipeMatcher.h"
+#include "ComponentIndex.h"
+#include "EmptyIngredient.h"
+#include "hashMaps.h"
+#include "RecipeInterner.h"
+#include "VariantClasses.h"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace crafting {
+
+RecipeMatcher recipeMatcher;
+
+// Where every construction session starts.
+static const EmptyIngredient emptyIngredient;
+
+uint32_t RecipeMatcher::getState(const Ingredient& ingredient, bool create) {
+    uint32_t* state = nullptr;
+    if(ingredient.getKind() == IngredientKind::CHARACTER) {
+        state = &characterStates[uint32_t(variantClasses.getRepresentative(static_cast<const Character&>(ingredient).getId()))];
+    }
+    else if(ingredient.getKind() == IngredientKind::RECIPE) {
+        const Recipe& recipe = static_cast<const Recipe&>(ingredient);
+        uint32_t recipeClass = create ? variantClasses.addRecipeClass(recipe) : variantClasses.getRecipeClass(recipe);
+        if(!create) {
+            auto it = recipeStates.find(recipeClass);
+            return it != recipeStates.end() ? it->second : NO_STATE;
+        }
+        state = &recipeStates.try_emplace(recipeClass, NO_STATE).first->second;
+    }
+    else {
+        return NO_STATE;
+    }
+    if(*state == NO_STATE && create) {
+        *state = numStates++;
+    }
+    return *state;
+}
+
+uint32_t RecipeMatcher::findState(const Ingredient& ingredient) const {
+    if(ingredient.getKind() == IngredientKind::CHARACTER) {
+        uint32_t id = uint32_t(variantClasses.getRepresentative(static_cast<const Character&>(ingredient).getId()));
+        return id < characterStates.size() ? characterStates[id] : NO_STATE;
+    }
+    if(ingredient.getKind() == IngredientKind::RECIPE) {
+        auto it = recipeStates.find(variantClasses.getRecipeClass(static_cast<const Recipe&>(ingredient)));
+        return it != recipeStates.end() ? it->second : NO_STATE;
+    }
+    return NO_STATE;
+}
+
+uint32_t RecipeMatcher::findRecipe(const Ingredient& ingredient) const {
+    if(ingredient.getKind() != IngredientKind::RECIPE) {
+        return NO_RECIPE;
+    }
+    const Recipe& recipe = static_cast<const Recipe&>(ingredient);
+    auto it = recipeIndices.find(recipe.getCanonicalId());
+    if(it == recipeIndices.end()) {
+        const Recipe* variant = variantClasses.findRecipe(recipe);
+        if(!variant) {
+            return NO_RECIPE;
+        }
+        it = recipeIndices.find(variant->getCanonicalId());
+    }
+    return it != recipeIndices.end() ? it->second : NO_RECIPE;
+}
+
+void RecipeMatcher::collectStates(const Ingredient& ingredient, std::vector<uint32_t>& states) {
+    states.push_back(getState(ingredient, true));
+    if(ingredient.getKind() != IngredientKind::RECIPE) {
+        return;
+    }
+    const Recipe& recipe = static_cast<const Recipe&>(ingredient);
+    if(recipe.getApprox()) {
+        return; // adding never makes approximated recipes
+    }
+    IngredientList ingredients = recipe.getIngredients();
+    auto isCharacter = [&](size_t i) { return ingredients[i]->getKind() == IngredientKind::CHARACTER; };
+    switch(recipe.getOperator().operator_c) {
+        case U'⿰':
+        case U'⿱':
+            // the recipe is made by adding the character on one side to the other side
+            if(isCharacter(0)) {
+                collectStates(*ingredients[1], states);
+            }
+            if(isCharacter(1)) {
+                collectStates(*ingredients[0], states);
+            }
+            return;
+        case U'⿲':
+        case U'⿳': {
+            // adding to a ⿰ or ⿱ recipe makes a ⿲ or ⿳ recipe
+            char32_t binary = recipe.getOperator().operator_c == U'⿲' ? U'⿰' : U'⿱';
+            if(isCharacter(0)) {
+                const Ingredient* rest[] = {ingredients[1], ingredients[2]};
+                collectStates(*recipeInterner.intern(binary, rest), states);
+            }
+            if(isCharacter(2)) {
+                const Ingredient* rest[] = {ingredients[0], ingredients[1]};
+                collectStates(*recipeInterner.intern(binary, rest), states);
+            }
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+void RecipeMatcher::build() {
+    characterStates.assign(characterTable.size() + 1, NO_STATE);
+    recipeStates.clear();
+    numStates = 0;
+    recipeIndices.clear();
+
+    std::vector<std::pair<uint32_t, uint32_t>> stateRecipePairs;
+    std::vector<uint32_t> states;
+    for(uint32_t i = 0; i < componentIndex.size(); i++) {
+        states.clear();
+        collectStates(componentIndex.getRecipe(i), states);
+        recipeIndices[componentIndex.getRecipe(i).getCanonicalId()] = i;
+        std::sort(states.begin(), states.end());
+        states.erase(std::unique(states.begin(), states.end()), states.end());
+        for(uint32_t state : states) {
+            stateRecipePairs.push_back({state, i});
+        }
+    }
+
+    reachableRecipes.reset(numStates);
+    for(const auto& pair : stateRecipePairs) {
+        reachableRecipes.count(pair.first);
+    }
+    reachableRecipes.allocate();
+    for(const auto& pair : stateRecipePairs) {
+        reachableRecipes.add(pair.first, pair.second);
+    }
+
+    recipeRegions.assign(componentIndex.size(), 0);
+    for(uint32_t i = 0; i < componentIndex.size(); i++) {
+        for(RegionMask regions : componentIndex.getResultRegions(i)) {
+            recipeRegions[i] |= regions;
+        }
+    }
+
+    // the results of the recipes, with the regions any of them makes each result in
+    std::vector<std::pair<CharacterId, RegionMask>> results;
+    auto collectResults = [&](util::ArrayView<uint32_t> recipes) {
+        results.clear();
+        for(uint32_t recipe : recipes) {
+            const std::vector<CharacterId>& recipeResults = componentIndex.getResults(recipe);
+            util::ArrayView<RegionMask> regions = componentIndex.getResultRegions(recipe);
+            for(size_t i = 0; i < recipeResults.size(); i++) {
+                results.push_back({recipeResults[i], regions[i]});
+            }
+        }
+        std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        size_t merged = 0;
+        for(size_t i = 1; i < results.size(); i++) {
+            if(results[i].first == results[merged].first) {
+                results[merged].second |= results[i].second;
+            }
+            else {
+                results[++merged] = results[i];
+            }
+        }
+        results.resize(std::min(results.size(), merged + 1));
+    };
+    reachableResults.reset(numStates);
+    reachableResultRegions.reset(numStates);
+    for(int pass = 0; pass < 2; pass++) {
+        for(uint32_t state = 0; state < numStates; state++) {
+            collectResults(reachableRecipes[state]);
+            if(pass == 0) {
+                reachableResults.count(state, results.size());
+                reachableResultRegions.count(state, results.size());
+            }
+            else {
+                for(const auto& [result, regions] : results) {
+                    reachableResults.add(state, result);
+                    reachableResultRegions.add(state, regions);
+                }
+            }
+        }
+        if(pass == 0) {
+            reachableResults.allocate();
+            reachableResultRegions.allocate();
+        }
+    }
+
+    allRecipes.resize(componentIndex.size());
+    std::iota(allRecipes.begin(), allRecipes.end(), 0);
+    collectResults(allRecipes);
+    allResults.clear();
+    allResultRegions.clear();
+    for(const auto& [result, regions] : results) {
+        allResults.push_back(result);
+        allResultRegions.push_back(regions);
+    }
+}
+
+/**
+ * @brief Gets the characters that are made in the region.
+ * @param regions The regions each of the characters is made in.
+*/
+static std::vector<CharacterId> filterResults(util::ArrayView<CharacterId> results, util::ArrayView<RegionMask> regions, Region region) {
+    std::vector<CharacterId> filtered;
+    for(size_t i = 0; i < results.size(); i++) {
+        if(isActiveIn(regions[i], region)) {
+            filtered.push_back(results[i]);
+        }
+    }
+    return filtered;
+}
+
+RecipeMatcher::Cursor::Cursor(const RecipeMatcher& matcher, Region region)
+    : matcher(&matcher)
+    , region(region)
+    , ingredient(&emptyIngredient)
+    , state(NO_STATE)
+{ }
+
+bool RecipeMatcher::Cursor::moveTo(const Ingredient* next) {
+    ingredient = next;
+    state = matcher->findState(*next);
+    return state != NO_STATE;
+}
+
+void RecipeMatcher::Cursor::reset() {
+    ingredient = &emptyIngredient;
+    state = NO_STATE;
+}
+
+std::vector<uint32_t> RecipeMatcher::Cursor::getReachableRecipes() const {
+    util::ArrayView<uint32_t> recipes;
+    if(ingredient->getKind() == IngredientKind::EMPTY) {
+        recipes = matcher->allRecipes;
+    }
+    else if(state != NO_STATE) {
+        recipes = matcher->reachableRecipes[state];
+    }
+    std::vector<uint32_t> filtered;
+    for(uint32_t recipe : recipes) {
+        if(isActiveIn(matcher->recipeRegions[recipe], region)) {
+            filtered.push_back(recipe);
+        }
+    }
+    return filtered;
+}
+
+std::vector<CharacterId> RecipeMatcher::Cursor::getReachableResults() const {
+    if(ingredient->getKind() == IngredientKind::EMPTY) {
+        return filterResults(matcher->allResults, matcher->allResultRegions, region);
+    }
+    if(state == NO_STATE) {
+        return {};
+    }
+    return filterResults(matcher->reachableResults[state], matcher->reachableResultRegions[state], region);
+}
+
+std::vector<CharacterId> RecipeMatcher::Cursor::getResults() const {
+    uint32_t recipe = matcher->findRecipe(*ingredient);
+    if(recipe == NO_RECIPE) {
+        return {};
+    }
+    return filterResults(componentIndex.getResults(recipe), componentIndex.getResultRegions(recipe), region);
+}
+
+} // namespace crafting
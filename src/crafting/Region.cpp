@@ -0,0 +1,36 @@
+#include "Region.h"
+#include "config.h"
+
+namespace crafting {
+
+// The letters of the regions, in the order of Region.
+static constexpr char regionLetters[] = "GHJKMPSTUBV";
+
+bool regionFromLetter(char letter, Region& region) {
+    for(int i = 0; i < int(Region::COUNT); i++) {
+        if(regionLetters[i] == letter) {
+            region = Region(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+RegionMask parseRegions(std::string_view flags) {
+    RegionMask regions = 0;
+    Region region;
+    for(char letter : flags) {
+        if(regionFromLetter(letter, region)) {
+            regions |= regionBit(region);
+        }
+    }
+    return regions;
+}
+
+Region getDefaultRegion() {
+    Region region = Region::U;
+    regionFromLetter(PREFERRED_CHARACTER_VARIANT, region);
+    return region;
+}
+
+} // namespace crafting
@@ -0,0 +1,130 @@
+#include "VariantClasses.h"
+#include "hashMaps.h"
+#include "RecipeInterner.h"
+#include <numeric>
+
+namespace crafting {
+
+VariantClasses variantClasses;
+
+uint32_t VariantClasses::findRoot(uint32_t id) {
+    while(parents[id] != id) {
+        parents[id] = parents[parents[id]]; // path halving
+        id = parents[id];
+    }
+    return id;
+}
+
+void VariantClasses::unite(CharacterId a, CharacterId b) {
+    size_t needed = std::max(uint32_t(a), uint32_t(b)) + 1;
+    if(parents.size() < needed) {
+        size_t oldSize = parents.size();
+        parents.resize(needed);
+        std::iota(parents.begin() + oldSize, parents.end(), oldSize);
+    }
+    uint32_t rootA = findRoot(uint32_t(a));
+    uint32_t rootB = findRoot(uint32_t(b));
+    if(rootA != rootB) {
+        parents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+}
+
+void VariantClasses::build() {
+    size_t numCharacters = characterTable.size() + 1;
+    size_t oldSize = parents.size();
+    parents.resize(std::max(oldSize, numCharacters));
+    std::iota(parents.begin() + oldSize, parents.end(), oldSize);
+
+    // the representative is the character with the lowest code point, so it does not depend on the loading order
+    std::vector<CharacterId> lowest(numCharacters, CharacterId::NONE);
+    for(uint32_t id = 1; id < numCharacters; id++) {
+        CharacterId& root = lowest[findRoot(id)];
+        if(root == CharacterId::NONE || characterTable[CharacterId(id)].getCharacter() < characterTable[root].getCharacter()) {
+            root = CharacterId(id);
+        }
+    }
+    representatives.assign(numCharacters, CharacterId::NONE);
+    members.reset(numCharacters);
+    for(uint32_t id = 1; id < numCharacters; id++) {
+        representatives[id] = lowest[findRoot(id)];
+        members.count(uint32_t(representatives[id]));
+    }
+    members.allocate();
+    for(uint32_t id = 1; id < numCharacters; id++) {
+        members.add(uint32_t(representatives[id]), CharacterId(id));
+    }
+
+    recipeClasses.clear();
+    recipesByClass.clear();
+    for(const auto& entry : recipeMap) {
+        const Recipe*& recipe = recipesByClass[addRecipeClass(entry.first)];
+        // the lowest id wins if several recipes are in the same class, so it does not depend on the map's order
+        if(!recipe || entry.first.getId() < recipe->getId()) {
+            recipe = &entry.first;
+        }
+    }
+}
+
+/**
+ * @brief Computes the canonical-level key of a recipe with every character replaced by its representative
+ * and every sub-recipe by its class, as given by getClass.
+*/
+template<typename GetClass>
+static RecipeKey makeClassKey(const VariantClasses& classes, const Recipe& recipe, GetClass getClass) {
+    IngredientList ingredients = recipe.getIngredients();
+    RecipeKey key{recipe.getOperator().operator_c, recipe.getApprox(), (uint8_t)ingredients.size(), {0, 0, 0}};
+    for(size_t i = 0; i < ingredients.size() && i < 3; i++) {
+        const Ingredient* ingredient = ingredients[i];
+        if(ingredient->getKind() == IngredientKind::CHARACTER) {
+            CharacterId representative = classes.getRepresentative(static_cast<const Character*>(ingredient)->getId());
+            key.ingredients[i] = characterTable[representative].getCharacter();
+        }
+        else if(ingredient->getKind() == IngredientKind::RECIPE) {
+            key.ingredients[i] = getClass(*static_cast<const Recipe*>(ingredient)) | RecipeKey::RECIPE_BIT;
+        }
+    }
+    return key;
+}
+
+uint32_t VariantClasses::addRecipeClass(const Recipe& recipe) {
+    if(representatives.empty()) {
+        return recipe.getCanonicalId();
+    }
+    if(recipe.getId() < recipeClasses.size() && recipeClasses[recipe.getId()] != 0) {
+        return recipeClasses[recipe.getId()];
+    }
+    RecipeKey key = makeClassKey(*this, recipe, [this](const Recipe& ingredient) { return addRecipeClass(ingredient); });
+    uint32_t recipeClass = recipeInterner.internCanonical(key);
+    if(recipeClasses.size() <= recipe.getId()) {
+        recipeClasses.resize(recipe.getId() + 1, 0);
+    }
+    recipeClasses[recipe.getId()] = recipeClass;
+    return recipeClass;
+}
+
+uint32_t VariantClasses::getRecipeClass(const Recipe& recipe) const {
+    if(representatives.empty()) {
+        return recipe.getCanonicalId();
+    }
+    if(recipe.getId() < recipeClasses.size() && recipeClasses[recipe.getId()] != 0) {
+        return recipeClasses[recipe.getId()];
+    }
+    bool known = true;
+    RecipeKey key = makeClassKey(*this, recipe, [&](const Recipe& ingredient) {
+        uint32_t recipeClass = getRecipeClass(ingredient);
+        known &= recipeClass != 0;
+        return recipeClass;
+    });
+    return known ? recipeInterner.findCanonical(key) : 0;
+}
+
+const Recipe* VariantClasses::findRecipe(const Recipe& recipe) const {
+    uint32_t recipeClass = getRecipeClass(recipe);
+    if(recipeClass == 0) {
+        return nullptr;
+    }
+    auto it = recipesByClass.find(recipeClass);
+    return it != recipesByClass.end() ? it->second : nullptr;
+}
+
+} // namespace crafting
@@ -1,35 +1,66 @@
 #include "hashMaps.h"
 #include "stringUtil.h"
 #include "config.h"
+#include "VariantClasses.h"
+#include "RadicalStrokeIndex.h"
 #include <iostream>
+#include <algorithm>
 
 namespace crafting {
 
-    std::unordered_map<Recipe, std::vector<std::shared_ptr<Character>>> recipeMap;
+    std::unordered_map<Recipe, std::vector<CharacterId>> recipeMap;
 
-    std::unordered_map<char32_t, std::shared_ptr<Character>> characterMap;
+    CharacterTable characterTable;
 
-    bool registerRecipe(char32_t result, std::u32string recipeString) {
+    util::StringPool meaningPool;
+
+    bool registerRecipe(char32_t result, const std::u32string& recipeString, RegionMask regions) {
         if(recipeString.find(U"？") != std::u32string::npos || recipeString.find(U"{") != std::u32string::npos) {
             // std::cerr << "Recipe contains unknown character." << std::endl;
             return false;
         }
-        for(std::shared_ptr<Character> c : recipeMap[recipeString]) {
-            if(c->getCharacter() == result) {
-                std::cerr << "Recipe already registered." << std::endl;
+        thread_local IdsParser parser;
+        IdsTree recipeTree;
+        try {
+            recipeTree = parser.parse(recipeString);
+        }
+        catch(IdsSyntaxError& e) {
+            throw std::runtime_error("Failed to register recipe: " + util::u32_to_u8(recipeString) + " for character: " + util::u32_to_u8(std::u32string(1, result)) + " with error: " + e.what());
+        }
+        return registerRecipe(result, recipeTree, regions);
+    }
+
+    bool registerRecipe(char32_t result, IdsTree recipeTree, RegionMask regions) {
+        for(size_t i = 0; i < recipeTree.size; i++) {
+            if(recipeTree.nodes[i].character == U'？' || recipeTree.nodes[i].character == U'{') {
                 return false;
             }
         }
-        std::shared_ptr<Character> character = getCharacter(result);
+        Character& character = getCharacter(result);
         try {
-            Recipe recipe(recipeString);
-            recipeMap[recipe].push_back(character);
-            character->addRecipe(recipe);
+            // the recipe string is only parsed once, the same object is used for the duplicate check and the registration
+            Recipe recipe(recipeTree);
+            std::vector<CharacterId>& results = recipeMap[recipe];
+            for(CharacterId id : results) {
+                if(id == character.getId()) {
+                    // the same recipe for another region, e.g. ⿲木木木 for one and ⿰木⿰木木 for another
+                    const std::vector<Recipe>& recipes = character.getRecipes();
+                    size_t index = std::find(recipes.begin(), recipes.end(), recipe) - recipes.begin();
+                    if((character.getRecipeRegions(index) | regions) == character.getRecipeRegions(index)) {
+                        std::cerr << "Recipe already registered." << std::endl;
+                        return false;
+                    }
+                    character.addRecipe(recipe, regions);
+                    return true;
+                }
+            }
+            results.push_back(character.getId());
+            character.addRecipe(recipe, regions);
             return true;
         }
         catch(std::runtime_error& e) {
             // pass
-            throw std::runtime_error("Failed to register recipe: " + util::u32_to_u8(recipeString) + " for character: " + util::u32_to_u8(std::u32string(1, result)) + " with error: " + e.what());
+            throw std::runtime_error("Failed to register recipe: " + util::u32_to_u8(idsToString(recipeTree)) + " for character: " + util::u32_to_u8(std::u32string(1, result)) + " with error: " + e.what());
             return false;
         }
     }
@@ -38,7 +69,7 @@ namespace crafting {
         if(meanings.size() == 0) {
             return false;
         }
-        std::shared_ptr<Character> c = getCharacter(character);
+        Character& c = getCharacter(character);
         int numAdded = 0;
         for(std::string& meaning : meanings) {
             // we don't want to add meanings that are not related to the character's meaning, like whether it's a radical or not
@@ -63,7 +94,7 @@ namespace crafting {
                 if((containsJ && ADDITIONAL_DEFINITIONS != 'J') || (containsCant && ADDITIONAL_DEFINITIONS != 'C')) {
                     continue;
                 }
-                c->addMeaning(meaningToAdd);
+                c.addMeaning(meaningToAdd);
                 numAdded++;
             }
             
@@ -76,11 +107,89 @@ namespace crafting {
         return registerMeanings(character, meaningVec);
     }
 
-    std::shared_ptr<Character> getCharacter(char32_t character) {
-        if(!characterMap[character]) {
-            characterMap[character] = std::make_shared<Character>(character);
+    bool registerVariants(char32_t character, char32_t variant) {
+        CharacterId characterId = characterTable.find(character);
+        CharacterId variantId = characterTable.find(variant);
+        if(characterId == CharacterId::NONE || variantId == CharacterId::NONE || characterId == variantId) {
+            return false;
+        }
+        const std::vector<char32_t>& alternatives = characterTable[characterId].getAlternatives();
+        if(std::find(alternatives.begin(), alternatives.end(), variant) == alternatives.end()) {
+            characterTable[characterId].addAlternative(variant);
+            characterTable[variantId].addAlternative(character);
+        }
+        variantClasses.unite(characterId, variantId);
+        return true;
+    }
+
+    bool registerRadicalStrokes(char32_t character, int radical, int radicalStrokes, int residualStrokes) {
+        CharacterId id = characterTable.find(character);
+        if(id == CharacterId::NONE || radical < 0 || radicalStrokes < 0 || residualStrokes < 0 || radical > UINT8_MAX
+                || radicalStrokes > UINT8_MAX || residualStrokes > UINT8_MAX) {
+            return false;
+        }
+        return radicalStrokeIndex.add(id, uint8_t(radical), uint8_t(radicalStrokes), uint8_t(residualStrokes));
+    }
+
+    bool isRecipeActive(const Recipe& recipe, CharacterId result, Region region) {
+        return characterTable[result].isRecipeActive(recipe, region);
+    }
+
+    const std::vector<CharacterId>* findRecipeResults(const Recipe& recipe, const Recipe** found) {
+        auto it = recipeMap.find(recipe);
+        if(it != recipeMap.end()) {
+            if(found) {
+                *found = &it->first;
+            }
+            return &it->second;
+        }
+        const Recipe* variant = variantClasses.findRecipe(recipe);
+        if(!variant) {
+            return nullptr;
+        }
+        if(found) {
+            *found = variant;
+        }
+        return &recipeMap.at(*variant);
+    }
+
+    Character& getCharacter(char32_t character) {
+        return characterTable[characterTable.getId(character)];
+    }
+
+    CharacterId getCharacterId(char32_t character) {
+        return characterTable.getId(character);
+    }
+
+    void printRecipeMapReport(std::ostream& out) {
+        size_t usedBuckets = 0;
+        size_t maxBucketSize = 0;
+        // bucketSizes[n] is the number of buckets with n recipes, the last entry counts all larger buckets
+        std::vector<size_t> bucketSizes(5, 0);
+        for(size_t i = 0; i < recipeMap.bucket_count(); i++) {
+            size_t size = recipeMap.bucket_size(i);
+            usedBuckets += size > 0;
+            maxBucketSize = std::max(maxBucketSize, size);
+            bucketSizes[std::min(size, bucketSizes.size() - 1)]++;
+        }
+        std::unordered_map<uint64_t, size_t> hashCounts;
+        hashCounts.reserve(recipeMap.size());
+        for(const auto& entry : recipeMap) {
+            hashCounts[entry.first.getHash()]++;
+        }
+        size_t collidingRecipes = 0;
+        for(const auto& hashCount : hashCounts) {
+            if(hashCount.second > 1) {
+                collidingRecipes += hashCount.second;
+            }
+        }
+        out << "Recipe map: " << recipeMap.size() << " recipes in " << recipeMap.bucket_count() << " buckets" << std::endl;
+        out << "Load factor: " << recipeMap.load_factor() << " (max " << recipeMap.max_load_factor() << ")" << std::endl;
+        out << "Used buckets: " << usedBuckets << ", largest bucket: " << maxBucketSize << std::endl;
+        for(size_t i = 0; i < bucketSizes.size(); i++) {
+            out << "Buckets with " << i << (i + 1 == bucketSizes.size() ? "+" : "") << " recipes: " << bucketSizes[i] << std::endl;
         }
-        return characterMap[character];
+        out << "Recipes sharing a full hash: " << collidingRecipes << std::endl;
     }
 
 } // namespace crafting
\ No newline at end of file
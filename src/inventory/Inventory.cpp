@@ -1,74 +1,121 @@
 #include "Inventory.h"
 #include "Recipe.h"
 #include "Character.h"
+#include "VariantClasses.h"
 
 namespace inventory {
 
 
-bool Inventory::addItem(char32_t item, unsigned int amount) {
+bool Inventory::addItem(crafting::CharacterId item, unsigned int amount) {
     if(getTotalAmount() + amount > capacity && capacity != 0) {
         return false;
     }
     items[item] += amount;
+    variantCounts[crafting::variantClasses.getRepresentative(item)] += amount;
     return true;
 }
 
-void Inventory::removeItem(char32_t item, int amount) {
-    if(items.find(item) != items.end()) {
-        if(amount < 0 || items[item] <= amount) {
-            items.erase(item);
+void Inventory::removeItem(crafting::CharacterId item, int amount) {
+    crafting::CharacterId representative = crafting::variantClasses.getRepresentative(item);
+    if(amount < 0) {
+        auto it = items.find(item);
+        if(it != items.end()) {
+            takeFromVariantCount(representative, it->second);
+            items.erase(it);
         }
-        else {
-            items[item] -= amount;
+        return;
+    }
+    // the item itself is taken first, then its variants
+    unsigned int remaining = takeItem(item, amount);
+    if(remaining > 0) {
+        for(crafting::CharacterId variant : crafting::variantClasses.getVariants(item)) {
+            if(variant != item) {
+                remaining = takeItem(variant, remaining);
+            }
         }
     }
+    takeFromVariantCount(representative, amount - remaining);
+}
+
+unsigned int Inventory::takeItem(crafting::CharacterId item, unsigned int amount) {
+    auto it = items.find(item);
+    if(it == items.end()) {
+        return amount;
+    }
+    if(it->second <= amount) {
+        amount -= it->second;
+        items.erase(it);
+        return amount;
+    }
+    it->second -= amount;
+    return 0;
+}
+
+void Inventory::takeFromVariantCount(crafting::CharacterId representative, unsigned int amount) {
+    auto it = variantCounts.find(representative);
+    if(it == variantCounts.end()) {
+        return;
+    }
+    if(it->second <= amount) {
+        variantCounts.erase(it);
+    }
+    else {
+        it->second -= amount;
+    }
 }
 
 void Inventory::clearInventory() {
     items.clear();
+    variantCounts.clear();
 }
 
-bool Inventory::hasItem(char32_t item, unsigned int amount) const {
-    auto it = items.find(item);
-    return it != items.end() && it->second >= amount;
+bool Inventory::hasItem(crafting::CharacterId item, unsigned int amount) const {
+    auto it = variantCounts.find(crafting::variantClasses.getRepresentative(item));
+    return it != variantCounts.end() && it->second >= amount;
+}
+
+void Inventory::countIngredients(const crafting::Ingredient& ingredient, std::map<crafting::CharacterId, unsigned int>& counts) {
+    switch(ingredient.getKind()) {
+        case crafting::IngredientKind::CHARACTER:
+            counts[crafting::variantClasses.getRepresentative(static_cast<const crafting::Character&>(ingredient).getId())]++;
+            return;
+        case crafting::IngredientKind::RECIPE:
+            for(const crafting::Ingredient* subIngredient : static_cast<const crafting::Recipe&>(ingredient).getIngredients()) {
+                countIngredients(*subIngredient, counts);
+            }
+            return;
+        default:
+            return;
+    }
 }
 
 bool Inventory::hasIngredients(const crafting::Ingredient& ingredient) const {
-    const crafting::Character* character_cast = dynamic_cast<const crafting::Character*>(&ingredient);
-    if(character_cast) {
-        return hasItem(character_cast->getCharacter());
+    if(ingredient.getKind() == crafting::IngredientKind::CHARACTER) {
+        return hasItem(static_cast<const crafting::Character&>(ingredient).getId());
     }
-    const crafting::Recipe* recipe_cast = dynamic_cast<const crafting::Recipe*>(&ingredient);
-    if(recipe_cast) {
-        for(const auto& subIngredient : recipe_cast->getIngredients()) {
-            if(!hasIngredients(*subIngredient.get())) {
-                return false;
-            }
+    if(ingredient.getKind() != crafting::IngredientKind::RECIPE) {
+        return false;
+    }
+    std::map<crafting::CharacterId, unsigned int> counts;
+    countIngredients(ingredient, counts);
+    for(const auto& count : counts) {
+        if(!hasItem(count.first, count.second)) {
+            return false;
         }
-        return true;
     }
-    return false;
+    return true;
 }
 
 bool Inventory::removeIngredients(const crafting::Ingredient& ingredient) {
     if(!hasIngredients(ingredient)) {
         return false;
     }
-    const crafting::Character* character_cast = dynamic_cast<const crafting::Character*>(&ingredient);
-    if(character_cast) {
-        removeItem(character_cast->getCharacter());
-        return true;
-    }
-    const crafting::Recipe* recipe_cast = dynamic_cast<const crafting::Recipe*>(&ingredient);
-    if(recipe_cast) {
-        for(const auto& subIngredient : recipe_cast->getIngredients()) {
-            if(!removeIngredients(*subIngredient.get())) {
-                return false;
-            }
-        }
-        return true;
+    std::map<crafting::CharacterId, unsigned int> counts;
+    countIngredients(ingredient, counts);
+    for(const auto& count : counts) {
+        removeItem(count.first, count.second);
     }
-    return false;
+    return true;
 }
 
 unsigned int Inventory::getTotalAmount() const {
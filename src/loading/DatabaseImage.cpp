@@ -0,0 +1,97 @@
+#include "DatabaseImage.h"
+#include "byteUtil.h"
+#include "config.h"
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace loading {
+
+// The files the database is built from, see loadRecipes, loadMeanings, loadVariants, loadDictionaryData and loadRadicalStrokeCounts.
+static const char* sourcePaths[] = {
+    "resources/ids/IDS_content_only.TXT",
+    "resources/ids/IDS_PUA.TXT",
+    READINGS_PATH,
+    #ifdef VARIANT_EQUIVALENCE
+    VARIANTS_PATH,
+    #endif
+    DICTIONARY_LIKE_DATA_PATH,
+    RADICAL_STROKE_COUNTS_PATH
+};
+
+uint64_t stampDatabaseSources() {
+    uint64_t stamp = util::fnv1a(std::string_view(image::MAGIC, 4));
+    // settings that change which data ends up in the database, the recipes of all regions are always in it
+    const char settings[] = {
+        ADDITIONAL_DEFINITIONS,
+        #ifdef LAZY_MEANINGS
+        'L', // the meanings are not in the image then
+        #endif
+        #ifdef VARIANT_EQUIVALENCE
+        'V', // the variants are only loaded then
+        #endif
+    };
+    stamp = util::fnv1a(std::string_view(settings, sizeof(settings)), stamp);
+    for(const char* path : sourcePaths) {
+        std::error_code error;
+        std::filesystem::path file = path;
+        if(!std::filesystem::exists(file, error)) {
+            file = std::filesystem::path("..") / path; // if executable is in build directory
+        }
+        stamp = util::fnv1a(path, stamp);
+        uintmax_t size = std::filesystem::file_size(file, error);
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(file, error);
+        if(error) {
+            stamp = util::fnv1a("<missing>", stamp);
+            continue;
+        }
+        stamp = util::hashCombine(stamp, uint64_t(size));
+        stamp = util::hashCombine(stamp, uint64_t(time.time_since_epoch().count()));
+    }
+    return stamp;
+}
+
+/**
+ * @brief Gets a pointer to a section of the image and advances the offset past it.
+ * @return The section, or nullptr if it does not fit into the image.
+*/
+template<typename T>
+static const T* takeSection(const util::MappedFile& file, size_t& offset, uint32_t count) {
+    size_t bytes = size_t(count) * sizeof(T);
+    if(offset + bytes > file.size()) {
+        return nullptr;
+    }
+    const T* section = reinterpret_cast<const T*>(file.data() + offset);
+    offset += bytes;
+    return section;
+}
+
+bool DatabaseImage::open(const std::string& path, uint64_t expectedStamp) {
+    if(!file.open(path)) {
+        return false;
+    }
+    if(file.size() < sizeof(image::ImageHeader)) {
+        return false;
+    }
+    mHeader = reinterpret_cast<const image::ImageHeader*>(file.data());
+    if(std::memcmp(mHeader->magic, image::MAGIC, sizeof(image::MAGIC)) != 0
+            || mHeader->version != image::VERSION
+            || mHeader->sourceStamp != expectedStamp) {
+        return false;
+    }
+    size_t offset = sizeof(image::ImageHeader);
+    mCharacters = takeSection<image::CharacterRecord>(file, offset, mHeader->numCharacters);
+    mNodes = takeSection<image::RecipeNode>(file, offset, mHeader->numNodes);
+    mRecipeRefs = takeSection<image::RecipeRef>(file, offset, mHeader->numRecipeRefs);
+    mRecipeMapEntries = takeSection<image::RecipeMapEntry>(file, offset, mHeader->numRecipeMapEntries);
+    mRecipeMapResults = takeSection<uint32_t>(file, offset, mHeader->numRecipeMapResults);
+    mMeaningRefs = takeSection<uint32_t>(file, offset, mHeader->numMeaningRefs);
+    mAlternatives = takeSection<uint32_t>(file, offset, mHeader->numAlternatives);
+    mFourCornerCodes = takeSection<uint32_t>(file, offset, mHeader->numFourCornerCodes);
+    mMeaningOffsets = takeSection<uint32_t>(file, offset, mHeader->numMeanings + 1);
+    mMeaningBytes = takeSection<char>(file, offset, mHeader->meaningBytes);
+    return mCharacters && mNodes && mRecipeRefs && mRecipeMapEntries && mRecipeMapResults && mMeaningRefs && mAlternatives
+        && mFourCornerCodes && mMeaningOffsets && mMeaningBytes;
+}
+
+} // namespace loading
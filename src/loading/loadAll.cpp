@@ -1,12 +1,64 @@
 #include "loading.h"
+#include "config.h"
+#include "ComponentIndex.h"
+#include "CraftabilitySolver.h"
+#include "DecompositionTable.h"
+#include "InputCodeIndex.h"
+#include "MeaningIndex.h"
+#include "RadicalStrokeIndex.h"
+#include "RecipeMatcher.h"
+#include "VariantClasses.h"
 
 namespace loading {
 
 void loadAll() {
+    #ifdef DATABASE_IMAGE_PATH
+    if(!loadDatabaseImage(DATABASE_IMAGE_PATH)) {
+        loadRecipes();
+        #ifndef LAZY_MEANINGS
+        loadMeanings();
+        #endif
+        loadCharacterFlags();
+        #ifdef VARIANT_EQUIVALENCE
+        loadVariants();
+        #endif
+        loadDictionaryData();
+        loadRadicalStrokeCounts();
+        writeDatabaseImage(DATABASE_IMAGE_PATH);
+    }
+    loadFreeType();
+    #else
     loadRecipes();
+    #ifndef LAZY_MEANINGS
     loadMeanings();
+    #endif
     loadFreeType();
     loadCharacterFlags();
+    #ifdef VARIANT_EQUIVALENCE
+    loadVariants();
+    #endif
+    loadDictionaryData();
+    loadRadicalStrokeCounts();
+    #endif
+    #ifdef LAZY_MEANINGS
+    loadMeaningsLazily();
+    #endif
+    #ifdef VARIANT_EQUIVALENCE
+    crafting::variantClasses.build();
+    #endif
+    crafting::cangjieIndex.build();
+    crafting::fourCornerIndex.build();
+    #ifndef LAZY_MEANINGS
+    // with lazy meanings, building the index would load all of them, so it is left to whoever needs it
+    crafting::meaningIndex.build();
+    #endif
+    crafting::radicalStrokeIndex.build();
+    crafting::componentIndex.build();
+    crafting::craftabilitySolver.build();
+    // the tables of other regions are built once a player of that region needs them
+    crafting::decompositionTables.clear();
+    crafting::decompositionTables.get(crafting::getDefaultRegion());
+    crafting::recipeMatcher.build();
 }
 
 } // namespace loading
\ No newline at end of file
@@ -4,48 +4,48 @@
 namespace loading {
 
 void loadCharacterFlags() {
-    crafting::getCharacter(U'辶')->setFreeSpaceInUpperRight(true);
-    crafting::getCharacter(U'𠃊')->setFreeSpaceInUpperRight(true);
-    crafting::getCharacter(U'㇄')->setFreeSpaceInUpperRight(true);
-    crafting::getCharacter(U'乚')->setFreeSpaceInUpperRight(true);
-    crafting::getCharacter(U'廴')->setFreeSpaceInUpperRight(true);
-    crafting::getCharacter(U'㇉')->setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'辶').setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'𠃊').setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'㇄').setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'乚').setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'廴').setFreeSpaceInUpperRight(true);
+    crafting::getCharacter(U'㇉').setFreeSpaceInUpperRight(true);
 
-    crafting::getCharacter(U'飞')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'㦰')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'𢦏')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'⺄')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'𠄎')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'𠃌')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'𠃍')->setFreeSpaceInLowerLeft(true);
-    crafting::getCharacter(U'㇈')->setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'飞').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'㦰').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'𢦏').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'⺄').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'𠄎').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'𠃌').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'𠃍').setFreeSpaceInLowerLeft(true);
+    crafting::getCharacter(U'㇈').setFreeSpaceInLowerLeft(true);
 
-    crafting::getCharacter(U'𠂋')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𠂉')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𠂇')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'屵')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'尸')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'产')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'严')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'丆')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'厂')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𠂆')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'厃')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'广')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𡰣')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'疒')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𤕫')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'𠃜')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
-    crafting::getCharacter(U'')->setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𠂋').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𠂉').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𠂇').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'屵').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'尸').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'产').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'严').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'丆').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'厂').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𠂆').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'厃').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'广').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𡰣').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'疒').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𤕫').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'𠃜').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
+    crafting::getCharacter(U'').setFreeSpaceInLowerRight(true);
 }
 
 } // namespace loading
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "loading.h"
+#include "DatabaseImage.h"
+#include "hashMaps.h"
+#include "DictionaryData.h"
+#include "RadicalStrokeIndex.h"
+#include "RecipeInterner.h"
+#include "VariantClasses.h"
+#include "config.h"
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#ifdef VERBOSE
+    #include <iostream>
+#endif
+
+namespace loading {
+
+bool loadDatabaseImage(const std::string& path) {
+    uint64_t sourceStamp = stampDatabaseSources();
+    DatabaseImage image;
+    if(!image.open(path, sourceStamp) && !image.open(std::string("../") + path, sourceStamp)) { // if executable is in build directory
+        return false;
+    }
+    const image::ImageHeader& header = image.header();
+
+    std::vector<crafting::Character*> characters;
+    characters.reserve(header.numCharacters);
+    for(uint32_t i = 0; i < header.numCharacters; i++) {
+        characters.push_back(&crafting::getCharacter(image.characters()[i].codePoint));
+    }
+
+    // nodes are stored in post-order, so all ingredients of a node have already been built when it is reached
+    std::vector<const crafting::Recipe*> nodes;
+    nodes.reserve(header.numNodes);
+    crafting::recipeInterner.reserve(crafting::recipeInterner.size() + header.numNodes);
+    std::vector<const crafting::Ingredient*> ingredients;
+    for(uint32_t i = 0; i < header.numNodes; i++) {
+        const image::RecipeNode& node = image.nodes()[i];
+        ingredients.clear();
+        for(int j = 0; j < node.numIngredients; j++) {
+            uint32_t ref = node.ingredients[j];
+            if(ref & image::CHARACTER_REF) {
+                ingredients.push_back(characters[ref & ~image::CHARACTER_REF]);
+            }
+            else {
+                ingredients.push_back(nodes[ref]);
+            }
+        }
+        nodes.push_back(crafting::recipeInterner.intern(node.op, ingredients, node.approx));
+    }
+
+    // every distinct meaning is interned once, the characters then only take over the ids
+    std::vector<uint32_t> meaningIds;
+    meaningIds.reserve(header.numMeanings);
+    for(uint32_t i = 0; i < header.numMeanings; i++) {
+        meaningIds.push_back(crafting::meaningPool.intern(image.meaning(i)));
+    }
+    crafting::meaningPool.freeze();
+
+    crafting::dictionaryData.reset(header.dictionaryFields);
+    for(uint32_t i = 0; i < header.numCharacters; i++) {
+        const image::CharacterRecord& record = image.characters()[i];
+        crafting::Character& character = *characters[i];
+        crafting::CharacterId id = character.getId();
+        for(uint32_t j = 0; j < record.numRecipes; j++) {
+            const image::RecipeRef& ref = image.recipeRefs()[record.firstRecipe + j];
+            character.addRecipe(*nodes[ref.node], ref.regions);
+        }
+        if(record.numMeanings > 0) {
+            std::vector<uint32_t>& meanings = crafting::characterTable.details(id).meanings;
+            for(uint32_t j = 0; j < record.numMeanings; j++) {
+                meanings.push_back(meaningIds[image.meaningRefs()[record.firstMeaning + j]]);
+            }
+        }
+        for(uint32_t j = 0; j < record.numAlternatives; j++) {
+            const crafting::Character& variant = *characters[image.alternatives()[record.firstAlternative + j]];
+            character.addAlternative(variant.getCharacter());
+            crafting::variantClasses.unite(id, variant.getId());
+        }
+        crafting::dictionaryData.addPacked(id, crafting::DictionaryField::CANGJIE, record.cangjie);
+        crafting::dictionaryData.addPacked(id, crafting::DictionaryField::FREQUENCY, record.frequency);
+        crafting::dictionaryData.addPacked(id, crafting::DictionaryField::GRADE_LEVEL, record.gradeLevel);
+        crafting::dictionaryData.addPacked(id, crafting::DictionaryField::UNIHAN_CORE_2020, record.coreRegions);
+        for(uint32_t j = 0; j < record.numFourCornerCodes; j++) {
+            crafting::dictionaryData.addPacked(id, crafting::DictionaryField::FOUR_CORNER_CODE,
+                image.fourCornerCodes()[record.firstFourCornerCode + j]);
+        }
+        if(record.radical != 0) {
+            crafting::radicalStrokeIndex.add(id, record.radical, record.radicalStrokes, record.residualStrokes);
+        }
+        // set after the recipes were built, since building them sets placement flags as well
+        character.setPlacementFlags(record.placementFlags);
+        character.setGlyphFlags(record.glyphFlags);
+    }
+    crafting::dictionaryData.build();
+
+    crafting::recipeMap.reserve(crafting::recipeMap.size() + header.numRecipeMapEntries);
+    for(uint32_t i = 0; i < header.numRecipeMapEntries; i++) {
+        const image::RecipeMapEntry& entry = image.recipeMapEntries()[i];
+        std::vector<crafting::CharacterId>& results = crafting::recipeMap[*nodes[entry.node]];
+        results.reserve(results.size() + entry.numResults);
+        for(uint32_t j = 0; j < entry.numResults; j++) {
+            results.push_back(characters[image.recipeMapResults()[entry.firstResult + j]]->getId());
+        }
+    }
+
+    #ifdef VERBOSE
+        std::cout << "Loaded " << header.numCharacters << " characters and "
+            << header.numRecipeMapEntries << " recipes from database image " << path << std::endl;
+    #endif
+    return true;
+}
+
+/**
+ * @brief Collects the data of the loaded database into the sections of an image.
+*/
+class ImageBuilder {
+private:
+    // nodes are deduplicated by recipe id, which is unique for each recipe tree
+    std::unordered_map<uint32_t, uint32_t> nodeIndices;
+public:
+    std::vector<image::CharacterRecord> characters;
+    std::vector<image::RecipeNode> nodes;
+    std::vector<image::RecipeRef> recipeRefs;
+    std::vector<image::RecipeMapEntry> recipeMapEntries;
+    std::vector<uint32_t> recipeMapResults;
+    std::vector<uint32_t> meaningRefs;
+    std::vector<uint32_t> alternatives;
+    std::vector<uint32_t> fourCornerCodes;
+    std::vector<uint32_t> meaningOffsets{0};
+    std::string meaningBytes;
+
+    ImageBuilder() {
+        // records are stored in the order of the character ids, so loading the image hands out the same ids again
+        characters.resize(crafting::characterTable.size());
+        for(const crafting::Character& character : crafting::characterTable) {
+            crafting::CharacterId id = character.getId();
+            image::CharacterRecord& record = characters[characterIndex(character)];
+            record.codePoint = character.getCharacter();
+            record.placementFlags = character.getPlacementFlags();
+            record.glyphFlags = character.getGlyphFlags();
+            record.coreRegions = crafting::dictionaryData.getCoreRegions(id);
+            record.cangjie = crafting::dictionaryData.getCangjie(id);
+            record.frequency = crafting::dictionaryData.getFrequency(id);
+            record.gradeLevel = crafting::dictionaryData.getGradeLevel(id);
+            crafting::RadicalStrokes radicalStrokes = crafting::radicalStrokeIndex.get(id);
+            record.radical = radicalStrokes.radical;
+            record.radicalStrokes = radicalStrokes.radicalStrokes;
+            record.residualStrokes = radicalStrokes.residualStrokes;
+            record.firstRecipe = recipeRefs.size();
+            record.numRecipes = character.getRecipes().size();
+            for(size_t i = 0; i < character.getRecipes().size(); i++) {
+                recipeRefs.push_back({addNode(character.getRecipes()[i]), character.getRecipeRegions(i), 0});
+            }
+            record.firstMeaning = meaningRefs.size();
+            if(const crafting::CharacterDetails* details = crafting::characterTable.findDetails(id)) {
+                meaningRefs.insert(meaningRefs.end(), details->meanings.begin(), details->meanings.end());
+            }
+            record.numMeanings = meaningRefs.size() - record.firstMeaning;
+            record.firstAlternative = alternatives.size();
+            for(char32_t alternative : character.getAlternatives()) {
+                crafting::CharacterId variant = crafting::characterTable.find(alternative);
+                if(variant != crafting::CharacterId::NONE) {
+                    alternatives.push_back(characterIndex(crafting::characterTable[variant]));
+                }
+            }
+            record.numAlternatives = alternatives.size() - record.firstAlternative;
+            record.firstFourCornerCode = fourCornerCodes.size();
+            for(uint32_t code : crafting::dictionaryData.getFourCornerCodes(id)) {
+                fourCornerCodes.push_back(code);
+            }
+            record.numFourCornerCodes = fourCornerCodes.size() - record.firstFourCornerCode;
+        }
+        // the meaning refs are ids in the meaning pool, so the pool is stored as is
+        for(uint32_t i = 0; i < crafting::meaningPool.size(); i++) {
+            meaningBytes += crafting::meaningPool[i];
+            meaningOffsets.push_back(meaningBytes.size());
+        }
+        for(const auto& entry : crafting::recipeMap) {
+            recipeMapEntries.push_back({addNode(entry.first), (uint32_t)recipeMapResults.size(), (uint32_t)entry.second.size()});
+            for(crafting::CharacterId result : entry.second) {
+                recipeMapResults.push_back(characterIndex(crafting::characterTable[result]));
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the index of the record of a character. Id 0 is no character, so the records start at id 1.
+    */
+    static uint32_t characterIndex(const crafting::Character& character) {
+        return uint32_t(character.getId()) - 1;
+    }
+
+    /**
+     * @brief Adds the recipe and its sub-recipes as nodes if they have not been added yet.
+     * @return The index of the node representing the recipe.
+    */
+    uint32_t addNode(const crafting::Recipe& recipe) {
+        auto it = nodeIndices.find(recipe.getId());
+        if(it != nodeIndices.end()) {
+            return it->second;
+        }
+        image::RecipeNode node{recipe.getOperator().operator_c, recipe.getApprox(), (uint8_t)recipe.getIngredients().size(), 0, {}};
+        for(size_t i = 0; i < recipe.getIngredients().size(); i++) {
+            const crafting::Ingredient* ingredient = recipe.getIngredients()[i];
+            if(ingredient->getKind() == crafting::IngredientKind::CHARACTER) {
+                node.ingredients[i] = characterIndex(*static_cast<const crafting::Character*>(ingredient)) | image::CHARACTER_REF;
+            }
+            else {
+                node.ingredients[i] = addNode(*static_cast<const crafting::Recipe*>(ingredient));
+            }
+        }
+        nodeIndices[recipe.getId()] = nodes.size();
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+};
+
+template<typename T>
+static void writeSection(std::ofstream& file, const std::vector<T>& section) {
+    file.write(reinterpret_cast<const char*>(section.data()), section.size() * sizeof(T));
+}
+
+bool writeDatabaseImage(const std::string& path) {
+    ImageBuilder builder;
+    image::ImageHeader header{};
+    std::copy(image::MAGIC, image::MAGIC + 4, header.magic);
+    header.version = image::VERSION;
+    header.sourceStamp = stampDatabaseSources();
+    header.numCharacters = builder.characters.size();
+    header.numNodes = builder.nodes.size();
+    header.numRecipeRefs = builder.recipeRefs.size();
+    header.numRecipeMapEntries = builder.recipeMapEntries.size();
+    header.numRecipeMapResults = builder.recipeMapResults.size();
+    header.numMeaningRefs = builder.meaningRefs.size();
+    header.numAlternatives = builder.alternatives.size();
+    header.numFourCornerCodes = builder.fourCornerCodes.size();
+    header.numMeanings = builder.meaningOffsets.size() - 1;
+    header.meaningBytes = builder.meaningBytes.size();
+    header.dictionaryFields = crafting::dictionaryData.getLoadedFields();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file) {
+        file.open(std::string("../") + path, std::ios::binary | std::ios::trunc); // if executable is in build directory
+    }
+    if(!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeSection(file, builder.characters);
+    writeSection(file, builder.nodes);
+    writeSection(file, builder.recipeRefs);
+    writeSection(file, builder.recipeMapEntries);
+    writeSection(file, builder.recipeMapResults);
+    writeSection(file, builder.meaningRefs);
+    writeSection(file, builder.alternatives);
+    writeSection(file, builder.fourCornerCodes);
+    writeSection(file, builder.meaningOffsets);
+    file.write(builder.meaningBytes.data(), builder.meaningBytes.size());
+    #ifdef VERBOSE
+        std::cout << "Wrote database image with " << header.numCharacters << " characters and "
+            << header.numNodes << " recipe nodes to " << path << std::endl;
+    #endif
+    return bool(file);
+}
+
+} // namespace loading
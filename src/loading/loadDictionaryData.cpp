@@ -0,0 +1,74 @@
+#include "loading.h"
+#include "config.h"
+#include "hashMaps.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <iterator>
+#include <string_view>
+#include <iostream>
+
+namespace loading {
+
+// The names of the fields in the dictionary like data file, by crafting::DictionaryField.
+static constexpr std::string_view FIELD_NAMES[] = {"kCangjie", "kFourCornerCode", "kFrequency", "kGradeLevel", "kUnihanCore2020"};
+static_assert(std::size(FIELD_NAMES) == size_t(crafting::DictionaryField::COUNT));
+
+void loadDictionaryData(std::string path, crafting::DictionaryFieldMask fields) {
+    util::MappedFile file;
+    if(!file.open(path) && !file.open(std::string("../") + path)) { // if executable is in build directory
+        throw std::runtime_error("Could not open dictionary like data file.");
+    }
+    #ifdef VERBOSE
+        std::cout << "Loading dictionary data from " << path << std::endl;
+        int numSuccess = 0;
+    #endif
+    crafting::dictionaryData.reset(fields);
+    std::string_view content = file.view();
+    size_t lineStart = 0;
+    while(lineStart < content.size()) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if(lineEnd == std::string_view::npos) {
+            lineEnd = content.size();
+        }
+        // e.g. "U+6728\tkCangjie\tD", the columns are viewed in place
+        std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if(!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        size_t typeStart = line.find('\t') + 1;
+        size_t valueStart = typeStart == 0 ? 0 : line.find('\t', typeStart) + 1;
+        if(line.size() < 3 || line[0] != 'U' || valueStart == 0) {
+            continue;
+        }
+        std::string_view type = line.substr(typeStart, valueStart - 1 - typeStart);
+        crafting::DictionaryField field = crafting::DictionaryField::COUNT;
+        for(size_t i = 0; i < std::size(FIELD_NAMES); i++) {
+            if(type == FIELD_NAMES[i]) {
+                field = crafting::DictionaryField(i);
+                break;
+            }
+        }
+        if(field == crafting::DictionaryField::COUNT || !(fields & crafting::fieldBit(field))) {
+            continue;
+        }
+        uint32_t codePoint = 0;
+        std::from_chars(line.data() + 2, line.data() + typeStart - 1, codePoint, 16);
+        crafting::CharacterId character = crafting::characterTable.find(codePoint);
+        if(character != crafting::CharacterId::NONE && crafting::dictionaryData.add(character, field, line.substr(valueStart))) {
+            #ifdef VERBOSE
+                numSuccess++;
+            #endif
+        }
+    }
+    crafting::dictionaryData.build();
+    #ifdef VERBOSE
+        std::cout << "Successfully loaded " << numSuccess << " dictionary entries." << std::endl;
+    #endif
+}
+
+void loadDictionaryData(crafting::DictionaryFieldMask fields) {
+    loadDictionaryData(DICTIONARY_LIKE_DATA_PATH, fields);
+}
+
+} // namespace loading
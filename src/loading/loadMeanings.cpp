@@ -2,6 +2,8 @@
 #include "config.h"
 #include "stringUtil.h"
 #include "hashMaps.h"
+#include "LazyMeanings.h"
+#include <charconv>
 #include <fstream>
 #include <vector>
 #include <string>
@@ -39,10 +41,49 @@ void loadMeanings() {
         #ifdef VERBOSE
             std::cout << "Successfully loaded meanings for " << numSuccess << " characters." << std::endl;
         #endif
+        // all meanings are loaded, so the pool does not need to find duplicates anymore
+        crafting::meaningPool.freeze();
     }
     else {
         throw std::runtime_error("Could not open readings file.");
     }
 }
 
+void loadMeaningsLazily(std::string path) {
+    if(!crafting::lazyMeanings.open(path) && !crafting::lazyMeanings.open(std::string("../") + path)) { // if executable is in build directory
+        throw std::runtime_error("Could not open readings file.");
+    }
+    #ifdef VERBOSE
+        std::cout << "Indexing meanings in " << path << std::endl;
+        int numSuccess = 0;
+    #endif
+    std::string_view content = crafting::lazyMeanings.view();
+    size_t lineStart = 0;
+    while(lineStart < content.size()) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if(lineEnd == std::string_view::npos) {
+            lineEnd = content.size();
+        }
+        // e.g. "U+6728\tkDefinition\ttree; wood, lumber; wooden", only the code point and the type are looked at
+        std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+        size_t typeStart = line.find('\t') + 1;
+        if(line.size() > 2 && line[0] == 'U' && typeStart != 0 && line.substr(typeStart, 12) == "kDefinition\t") {
+            uint32_t codePoint = 0;
+            std::from_chars(line.data() + 2, line.data() + typeStart - 1, codePoint, 16);
+            crafting::lazyMeanings.add(crafting::getCharacterId(codePoint), lineStart);
+            #ifdef VERBOSE
+                numSuccess++;
+            #endif
+        }
+        lineStart = lineEnd + 1;
+    }
+    #ifdef VERBOSE
+        std::cout << "Found meanings for " << numSuccess << " characters." << std::endl;
+    #endif
+}
+
+void loadMeaningsLazily() {
+    loadMeaningsLazily(READINGS_PATH);
+}
+
 } // namespace loading
\ No newline at end of file
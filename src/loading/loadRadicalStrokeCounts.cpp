@@ -0,0 +1,64 @@
+#include "loading.h"
+#include "config.h"
+#include "stringUtil.h"
+#include "hashMaps.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace loading {
+
+void loadRadicalStrokeCounts() {
+    std::ifstream radicalStrokeCountsFile;
+    radicalStrokeCountsFile.open(RADICAL_STROKE_COUNTS_PATH);
+    std::string line;
+    if(!radicalStrokeCountsFile) {
+        radicalStrokeCountsFile.open(std::string("../") + RADICAL_STROKE_COUNTS_PATH); // if executable is in build directory
+    }
+    if(radicalStrokeCountsFile) {
+        #ifdef VERBOSE
+            std::cout << "Loading radical stroke counts from " << RADICAL_STROKE_COUNTS_PATH << std::endl;
+            int numSuccess = 0;
+        #endif
+        while(std::getline(radicalStrokeCountsFile, line)) {
+            if(line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::vector<std::string> columns = util::split<char>(line, "\t");
+            if(columns.size() < 3 || columns[1] != "kRSAdobe_Japan1_6") {
+                continue;
+            }
+            // e.g. "C+13698+1.1.5 V+13697+21.2.4": glyph kind (C for the same glyph as the character, V for a variant one),
+            // glyph id, then radical, strokes of the radical and residual strokes
+            std::vector<std::string> values = util::split<char>(columns[2], " ");
+            std::string value = values[0];
+            for(const std::string& candidate : values) {
+                if(candidate[0] == 'C') {
+                    value = candidate;
+                    break;
+                }
+            }
+            std::vector<std::string> fields = util::split<char>(value, "+");
+            if(fields.size() != 3) {
+                throw std::runtime_error("Invalid radical stroke count " + value + " in radical stroke counts file.");
+            }
+            std::vector<std::string> counts = util::split<char>(fields[2], ".");
+            if(counts.size() != 3) {
+                throw std::runtime_error("Invalid radical stroke count " + value + " in radical stroke counts file.");
+            }
+            #ifdef VERBOSE
+                numSuccess +=
+            #endif
+            crafting::registerRadicalStrokes(util::unicodeToChar(columns[0]), std::stoi(counts[0]), std::stoi(counts[1]), std::stoi(counts[2]));
+        }
+        #ifdef VERBOSE
+            std::cout << "Successfully loaded " << numSuccess << " radical stroke counts." << std::endl;
+        #endif
+    }
+    else {
+        throw std::runtime_error("Could not open radical stroke counts file.");
+    }
+}
+
+} // namespace loading
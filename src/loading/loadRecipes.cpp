@@ -2,15 +2,45 @@
 #include "config.h"
 #include "stringUtil.h"
 #include "hashMaps.h"
+#include "MappedFile.h"
+#include "parallelUtil.h"
 #include <fstream>
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <string_view>
 #ifdef VERBOSE 
     #include <iostream>
 #endif
 
 namespace loading {
 
+/**
+ * @brief Gets the regions each of the regional recipes of a line is used in, see crafting::Region.
+ * A recipe is used in the regions of its source references, the one used in most countries also in all regions
+ * that none of the recipes is for, so that every region has a recipe for the character.
+ * @param recipes The recipes with their source references, e.g. (GHJKTV).
+*/
+template<typename Recipes>
+static void assignRegions(const Recipes& recipes, std::vector<crafting::RegionMask>& regions) {
+    regions.assign(recipes.size(), 0);
+    if(recipes.empty()) {
+        return;
+    }
+    crafting::RegionMask covered = 0;
+    size_t mostCountries = 0;
+    size_t max = 0;
+    for(size_t i = 0; i < recipes.size(); i++) {
+        regions[i] = crafting::parseRegions(recipes[i].second);
+        covered |= regions[i];
+        if(recipes[i].second.size() > max) {
+            max = recipes[i].second.size();
+            mostCountries = i;
+        }
+    }
+    regions[mostCountries] |= crafting::ALL_REGIONS & ~covered;
+}
+
 /**
  * @brief Loads the recipes from the IDS file.
  * @throws std::runtime_error if the IDS file could not be opened or if the file is invalid.
@@ -59,39 +89,22 @@ void loadRecipes(std::string path) {
                 }
             }
             if(recipes.size() > 0) {
-                std::string recipeString;
-                int max = 0;
-                int maxIndex = 0;
-                bool inserted = false;
-                // Besides the alternate recipes, marked with X, from the other recipes we select the one for the preferred variant if it exists,
-                // otherwise we select the one used in most countries
-                for(int i = 0; i < recipes.size(); i++) {
-                    std::string r = recipes[i].first;
-                    std::string flags = recipes[i].second;
-                    if(flags.find(PREFERRED_CHARACTER_VARIANT) != std::string::npos) {
-                        recipeString = r;
-                        inserted = true;
-                        break;
-                    }
-                    else {
-                        if(flags.size() > max) {
-                            max = flags.size();
-                            maxIndex = i;
-                        }
-                    }
-                }
-                if(!inserted) {
-                    recipeString = recipes[maxIndex].first;
-                }
                 std::u32string u32char = util::u8_to_u32(character);
                 if(u32char.size() > 1) {
                     throw std::runtime_error("Invalid character at line " + std::to_string(lineNum) + ". Length > 1.");
                 }
-                #ifdef VERBOSE
-                    numSuccess +=
-                #endif
-                crafting::registerRecipe(u32char[0], util::u8_to_u32(recipeString));
-                
+                // Besides the alternate recipes, marked with X, all regional variants are kept, see assignRegions
+                std::vector<crafting::RegionMask> regions;
+                assignRegions(recipes, regions);
+                for(int i = 0; i < recipes.size(); i++) {
+                    if(regions[i] == 0) {
+                        continue;
+                    }
+                    #ifdef VERBOSE
+                        numSuccess +=
+                    #endif
+                    crafting::registerRecipe(u32char[0], util::u8_to_u32(recipes[i].first), regions[i]);
+                }
             }
             for(std::string& alt : alternateRecipes) {
                 std::u32string u32char = util::u8_to_u32(character);
@@ -114,9 +127,317 @@ void loadRecipes(std::string path) {
     }
 }
 
+/**
+ * @brief Splits memory-mapped IDS content into lines and selects the recipes to register for each of them.
+ * The buffers are reused for every line, so that no allocation happens once they have grown large enough.
+*/
+class IdsLineParser {
+private:
+    std::vector<std::pair<std::string_view, std::string_view>> recipes;
+    std::vector<std::string_view> alternateRecipes;
+    std::vector<crafting::RegionMask> regions;
+    std::u32string u32recipe;
+public:
+    /**
+     * @brief Calls onRecipe(char32_t character, const std::u32string& recipe, crafting::RegionMask regions) for every recipe
+     * of the line that should be registered, with the regions it is used in.
+     * @param line The line without line break.
+     * @param lineNum The line number, used for error messages.
+     * @throws std::runtime_error if the line is invalid.
+    */
+    template<typename Callback>
+    void parseLine(std::string_view line, int lineNum, Callback onRecipe) {
+        if(!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if(line.empty() || line[0] == '#') {
+            return;
+        }
+        recipes.clear();
+        alternateRecipes.clear();
+        std::string_view character;
+        int columnNum = 0;
+        size_t columnStart = 0;
+        while(columnStart <= line.size()) {
+            size_t columnEnd = line.find('\t', columnStart);
+            if(columnEnd == std::string_view::npos) {
+                columnEnd = line.size();
+            }
+            std::string_view column = line.substr(columnStart, columnEnd - columnStart);
+            columnStart = columnEnd + 1;
+            if(columnNum++ == 1) {
+                character = column;
+            }
+            else if(columnNum > 2 && !column.empty() && column[0] == '^') {
+                size_t dollarPos = column.find('$');
+                if(dollarPos == std::string_view::npos) {
+                    throw std::runtime_error("Invalid recipe format at line " + std::to_string(lineNum) + " in IDS file. Missing dollar sign.");
+                }
+                std::string_view flags = column.substr(dollarPos + 1);
+                std::string_view recipe = column.substr(1, dollarPos - 1);
+                size_t recipeLength = util::u8_length(recipe);
+                if(flags == "(UCS2003)" || flags == "(Z)" || recipeLength <= 1 || (recipeLength <= 2 && recipe.substr(0, 3) == "\xE3\x80\xBE")) { // U+303E 〾
+                    continue;
+                }
+                else if(flags == "(X)") {
+                    alternateRecipes.push_back(recipe);
+                }
+                else {
+                    recipes.push_back({recipe, flags});
+                }
+            }
+        }
+        if(recipes.empty() && alternateRecipes.empty()) {
+            return;
+        }
+        size_t charPos = 0;
+        char32_t u32char = character.empty() ? 0 : util::decodeUtf8(character, charPos);
+        if(charPos != character.size()) {
+            throw std::runtime_error("Invalid character at line " + std::to_string(lineNum) + ". Length > 1.");
+        }
+        // Same regions as in the stream based loader
+        assignRegions(recipes, regions);
+        for(size_t i = 0; i < recipes.size(); i++) {
+            if(regions[i] != 0) {
+                util::u8_to_u32(recipes[i].first, u32recipe);
+                onRecipe(u32char, u32recipe, regions[i]);
+            }
+        }
+        for(std::string_view alt : alternateRecipes) {
+            util::u8_to_u32(alt, u32recipe);
+            onRecipe(u32char, u32recipe, crafting::ALL_REGIONS);
+        }
+    }
+};
+
+/**
+ * @brief Maps an IDS file, trying the build directory's parent as well.
+ * @return The content of the file without byte order mark.
+ * @throws std::runtime_error if the IDS file could not be opened.
+*/
+static std::string_view mapIdsFile(util::MappedFile& idsFile, const std::string& path) {
+    if(!idsFile.open(path)) {
+        idsFile.open(std::string("../") + path); // if executable is in build directory
+    }
+    if(!idsFile) {
+        throw std::runtime_error("Could not open IDS file.");
+    }
+    std::string_view content = idsFile.view();
+    if(content.substr(0, 3) == "\xEF\xBB\xBF") {
+        content.remove_prefix(3); // byte order mark
+    }
+    return content;
+}
+
+/**
+ * @brief Calls onLine(std::string_view line) for every line of the content, without the line break.
+*/
+template<typename Callback>
+static void forEachLine(std::string_view content, Callback onLine) {
+    size_t lineStart = 0;
+    while(lineStart < content.size()) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if(lineEnd == std::string_view::npos) {
+            lineEnd = content.size();
+        }
+        onLine(content.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Splits the content into chunks at line boundaries, to be processed on several threads.
+ * There are more chunks than threads, so that uneven chunks are balanced.
+ * Calls onChunk(std::string_view chunk, int firstLineNum) for every chunk, in order.
+*/
+template<typename Callback>
+static void splitIntoChunks(std::string_view content, unsigned int threads, Callback onChunk) {
+    size_t numChunks = threads * 8;
+    size_t chunkStart = 0;
+    int lineNum = 1;
+    for(size_t i = 1; i <= numChunks && chunkStart < content.size(); i++) {
+        size_t chunkEnd = i == numChunks ? content.size() : content.size() * i / numChunks;
+        if(chunkEnd < chunkStart) {
+            chunkEnd = chunkStart;
+        }
+        chunkEnd = content.find('\n', chunkEnd);
+        chunkEnd = chunkEnd == std::string_view::npos ? content.size() : chunkEnd + 1;
+        std::string_view chunk = content.substr(chunkStart, chunkEnd - chunkStart);
+        onChunk(chunk, lineNum);
+        lineNum += std::count(chunk.begin(), chunk.end(), '\n');
+        chunkStart = chunkEnd;
+    }
+}
+
+void loadRecipesMapped(std::string path) {
+    util::MappedFile idsFile;
+    std::string_view content = mapIdsFile(idsFile, path);
+    #ifdef VERBOSE
+        std::cout << "Loading recipes from " << path << " (memory-mapped)" << std::endl;
+        int numSuccess = 0;
+    #endif
+    IdsLineParser parser;
+    int lineNum = 0;
+    forEachLine(content, [&](std::string_view line) {
+        parser.parseLine(line, ++lineNum, [&](char32_t character, const std::u32string& recipe, crafting::RegionMask regions) {
+            #ifdef VERBOSE
+                numSuccess +=
+            #endif
+            crafting::registerRecipe(character, recipe, regions);
+        });
+    });
+    #ifdef VERBOSE
+        std::cout << "Successfully loaded " << numSuccess << " recipes." << std::endl;
+    #endif
+}
+
+/**
+ * @brief The recipes selected from one chunk of an IDS file, waiting to be registered.
+*/
+struct ParsedChunk {
+    // The content of the chunk, starting and ending at line boundaries.
+    std::string_view content;
+    // The parsed trees of all pending recipes, stored back to back.
+    std::vector<crafting::IdsNode> recipeNodes;
+    struct PendingRecipe {
+        char32_t character;
+        uint32_t offset;
+        uint32_t size;
+        crafting::RegionMask regions;
+    };
+    std::vector<PendingRecipe> pending;
+    // The line number of the first line of the chunk.
+    int firstLineNum = 1;
+    // Set if the chunk contains an invalid line or recipe. Only the recipes before it are pending.
+    bool failed = false;
+    std::string error;
+    // The malformed recipe, if that is what made the chunk fail. It is registered to get the same error as the serial loader.
+    char32_t failedCharacter = 0;
+    std::u32string failedRecipe;
+};
+
+void loadRecipesParallel(std::string path, unsigned int threads) {
+    util::MappedFile idsFile;
+    std::string_view content = mapIdsFile(idsFile, path);
+    threads = util::threadCount(threads);
+    #ifdef VERBOSE
+        std::cout << "Loading recipes from " << path << " (" << threads << " threads)" << std::endl;
+        int numSuccess = 0;
+    #endif
+
+    std::vector<ParsedChunk> chunks;
+    splitIntoChunks(content, threads, [&](std::string_view chunkContent, int firstLineNum) {
+        chunks.emplace_back();
+        chunks.back().content = chunkContent;
+        chunks.back().firstLineNum = firstLineNum;
+    });
+
+    // Tokenizing and parsing the recipes happens into per-chunk buffers, without touching the global maps.
+    // Errors are recorded rather than thrown, so that everything before the invalid line is still registered, like in the serial loader.
+    util::parallelFor(chunks.size(), [&](size_t index, unsigned int) {
+        ParsedChunk& chunk = chunks[index];
+        IdsLineParser parser;
+        crafting::IdsParser idsParser;
+        int lineNum = chunk.firstLineNum;
+        try {
+            forEachLine(chunk.content, [&](std::string_view line) {
+                parser.parseLine(line, lineNum++, [&](char32_t character, const std::u32string& recipe, crafting::RegionMask regions) {
+                    if(recipe.find(U'？') != std::u32string::npos || recipe.find(U'{') != std::u32string::npos) {
+                        return; // rejected by registerRecipe anyway
+                    }
+                    try {
+                        size_t offset = idsParser.parseInto(recipe, chunk.recipeNodes);
+                        chunk.pending.push_back({character, (uint32_t)offset, (uint32_t)(chunk.recipeNodes.size() - offset), regions});
+                    }
+                    catch(crafting::IdsSyntaxError& e) {
+                        chunk.failedCharacter = character;
+                        chunk.failedRecipe = recipe;
+                        throw;
+                    }
+                });
+            });
+        }
+        catch(std::runtime_error& e) {
+            chunk.failed = true;
+            chunk.error = e.what();
+        }
+    }, threads);
+
+    // Merging happens in file order, so the result is the same as if the file was loaded serially.
+    for(ParsedChunk& chunk : chunks) {
+        for(const ParsedChunk::PendingRecipe& pending : chunk.pending) {
+            #ifdef VERBOSE
+                numSuccess +=
+            #endif
+            crafting::registerRecipe(pending.character, crafting::IdsTree{chunk.recipeNodes.data() + pending.offset, pending.size}, pending.regions);
+        }
+        if(chunk.failed) {
+            if(!chunk.failedRecipe.empty()) {
+                crafting::registerRecipe(chunk.failedCharacter, chunk.failedRecipe);
+            }
+            throw std::runtime_error(chunk.error);
+        }
+    }
+    #ifdef VERBOSE
+        std::cout << "Successfully loaded " << numSuccess << " recipes." << std::endl;
+    #endif
+}
+
+std::vector<RecipeError> findRecipeErrors(std::string path, unsigned int threads) {
+    util::MappedFile idsFile;
+    std::string_view content = mapIdsFile(idsFile, path);
+    std::vector<std::string_view> chunks;
+    std::vector<int> firstLineNums;
+    splitIntoChunks(content, util::threadCount(threads), [&](std::string_view chunk, int firstLineNum) {
+        chunks.push_back(chunk);
+        firstLineNums.push_back(firstLineNum);
+    });
+    // unlike when loading, every line is checked, so errors are recorded per line instead of stopping the chunk
+    std::vector<std::vector<RecipeError>> chunkErrors(chunks.size());
+    util::parallelFor(chunks.size(), [&](size_t index, unsigned int) {
+        IdsLineParser parser;
+        crafting::IdsParser idsParser;
+        std::vector<crafting::IdsNode> nodes;
+        int lineNum = firstLineNums[index];
+        forEachLine(chunks[index], [&](std::string_view line) {
+            try {
+                parser.parseLine(line, lineNum, [&](char32_t character, const std::u32string& recipe, crafting::RegionMask) {
+                    if(recipe.find(U'？') != std::u32string::npos || recipe.find(U'{') != std::u32string::npos) {
+                        return; // unencoded components, skipped when loading
+                    }
+                    try {
+                        nodes.clear();
+                        idsParser.parseInto(recipe, nodes);
+                    }
+                    catch(crafting::IdsSyntaxError& e) {
+                        chunkErrors[index].push_back({path, lineNum, character, recipe, e.what()});
+                    }
+                });
+            }
+            catch(std::runtime_error& e) {
+                chunkErrors[index].push_back({path, lineNum, 0, U"", e.what()});
+            }
+            lineNum++;
+        });
+    }, threads);
+    std::vector<RecipeError> errors;
+    for(std::vector<RecipeError>& chunk : chunkErrors) {
+        errors.insert(errors.end(), chunk.begin(), chunk.end());
+    }
+    return errors;
+}
+
 void loadRecipes() {
-    loadRecipes("resources/ids/IDS_content_only.TXT");
-    loadRecipes("resources/ids/IDS_PUA.TXT");
+    #if defined(MEMORY_MAPPED_LOADING) && LOADING_THREADS != 1
+        loadRecipesParallel("resources/ids/IDS_content_only.TXT", LOADING_THREADS);
+        loadRecipesParallel("resources/ids/IDS_PUA.TXT", LOADING_THREADS);
+    #elif defined(MEMORY_MAPPED_LOADING)
+        loadRecipesMapped("resources/ids/IDS_content_only.TXT");
+        loadRecipesMapped("resources/ids/IDS_PUA.TXT");
+    #else
+        loadRecipes("resources/ids/IDS_content_only.TXT");
+        loadRecipes("resources/ids/IDS_PUA.TXT");
+    #endif
 }
 
 } // namespace loading
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "loading.h"
+#include "config.h"
+#include "stringUtil.h"
+#include "hashMaps.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace loading {
+
+// The kinds of links that make characters variants of each other. Specialized semantic variants are only
+// the same in some meanings, and spoofing variants only look alike, so they are left out.
+static const char* variantTypes[] = {
+    "kSemanticVariant",
+    "kSimplifiedVariant",
+    "kTraditionalVariant",
+    "kZVariant"
+};
+
+void loadVariants() {
+    std::ifstream variantsFile;
+    variantsFile.open(VARIANTS_PATH);
+    std::string line;
+    if(!variantsFile) {
+        variantsFile.open(std::string("../") + VARIANTS_PATH); // if executable is in build directory
+    }
+    if(variantsFile) {
+        #ifdef VERBOSE
+            std::cout << "Loading variants from " << VARIANTS_PATH << std::endl;
+            int numSuccess = 0;
+        #endif
+        while(std::getline(variantsFile, line)) {
+            if(line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::vector<std::string> columns = util::split<char>(line, "\t");
+            if(columns.size() < 3) {
+                continue;
+            }
+            bool isVariantType = false;
+            for(const char* type : variantTypes) {
+                isVariantType |= columns[1] == type;
+            }
+            if(!isVariantType) {
+                continue;
+            }
+            char32_t character = util::unicodeToChar(columns[0]);
+            // e.g. "U+4EBB<kMatthews U+5165", the sources after < are not needed
+            for(const std::string& variant : util::split<char>(columns[2], " ")) {
+                #ifdef VERBOSE
+                    numSuccess +=
+                #endif
+                crafting::registerVariants(character, util::unicodeToChar(variant.substr(0, variant.find('<'))));
+            }
+        }
+        #ifdef VERBOSE
+            std::cout << "Successfully loaded " << numSuccess << " variant links." << std::endl;
+        #endif
+    }
+    else {
+        throw std::runtime_error("Could not open variants file.");
+    }
+}
+
+} // namespace loading
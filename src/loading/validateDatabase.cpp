@@ -0,0 +1,326 @@
+#include "DatabaseReport.h"
+#include "ComponentIndex.h"
+#include "hashMaps.h"
+#include "parallelUtil.h"
+#include "stringUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace loading {
+
+/**
+ * @brief Collects the characters used in a recipe without duplicates.
+*/
+static void collectLeaves(const crafting::Recipe& recipe, std::vector<uint32_t>& leaves) {
+    std::vector<const crafting::Recipe*> stack{&recipe};
+    while(!stack.empty()) {
+        const crafting::Recipe* current = stack.back();
+        stack.pop_back();
+        for(const crafting::Ingredient* ingredient : current->getIngredients()) {
+            if(ingredient->getKind() == crafting::IngredientKind::CHARACTER) {
+                leaves.push_back(uint32_t(static_cast<const crafting::Character*>(ingredient)->getId()));
+            }
+            else if(ingredient->getKind() == crafting::IngredientKind::RECIPE) {
+                stack.push_back(static_cast<const crafting::Recipe*>(ingredient));
+            }
+        }
+    }
+    std::sort(leaves.begin(), leaves.end());
+    leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+}
+
+/**
+ * @brief Finds the strongly connected components of the component graph with Tarjan's algorithm, without recursion.
+ * @return The components that form cycles, i.e. with more than one character or with a character using itself.
+*/
+static std::vector<std::vector<crafting::CharacterId>> findCycles(const std::vector<std::vector<uint32_t>>& components) {
+    constexpr uint32_t UNVISITED = UINT32_MAX;
+    size_t numCharacters = components.size();
+    std::vector<uint32_t> index(numCharacters, UNVISITED);
+    std::vector<uint32_t> lowLink(numCharacters, 0);
+    std::vector<bool> onStack(numCharacters, false);
+    std::vector<uint32_t> stack;
+    // the characters being visited and the next of their components to look at
+    std::vector<std::pair<uint32_t, size_t>> visiting;
+    std::vector<std::vector<crafting::CharacterId>> cycles;
+    uint32_t nextIndex = 0;
+    for(uint32_t root = 1; root < numCharacters; root++) {
+        if(index[root] != UNVISITED) {
+            continue;
+        }
+        visiting.push_back({root, 0});
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        onStack[root] = true;
+        while(!visiting.empty()) {
+            auto& [character, next] = visiting.back();
+            if(next < components[character].size()) {
+                uint32_t component = components[character][next++];
+                if(index[component] == UNVISITED) {
+                    index[component] = lowLink[component] = nextIndex++;
+                    stack.push_back(component);
+                    onStack[component] = true;
+                    visiting.push_back({component, 0});
+                }
+                else if(onStack[component]) {
+                    lowLink[character] = std::min(lowLink[character], index[component]);
+                }
+                continue;
+            }
+            uint32_t finished = character;
+            visiting.pop_back();
+            if(!visiting.empty()) {
+                uint32_t parent = visiting.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[finished]);
+            }
+            if(lowLink[finished] != index[finished]) {
+                continue;
+            }
+            std::vector<crafting::CharacterId> cycle;
+            uint32_t member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                cycle.push_back(crafting::CharacterId(member));
+            } while(member != finished);
+            const std::vector<uint32_t>& own = components[finished];
+            if(cycle.size() > 1 || std::binary_search(own.begin(), own.end(), finished)) {
+                std::sort(cycle.begin(), cycle.end());
+                cycles.push_back(std::move(cycle));
+            }
+        }
+    }
+    std::sort(cycles.begin(), cycles.end());
+    return cycles;
+}
+
+/**
+ * @brief Follows how characters are rendered, see Character::render, to find the ones where it fails.
+*/
+class RenderChecker {
+private:
+    enum State : uint8_t { UNVISITED, VISITING, RENDERABLE, BROKEN };
+    const std::vector<bool>& inFontFaces;
+    const std::vector<std::vector<uint32_t>>& firstRecipeComponents;
+    std::vector<State> states;
+    std::vector<DatabaseReport::BrokenRender> failures;
+public:
+    RenderChecker(const std::vector<bool>& inFontFaces, const std::vector<std::vector<uint32_t>>& firstRecipeComponents)
+        : inFontFaces(inFontFaces)
+        , firstRecipeComponents(firstRecipeComponents)
+        , states(inFontFaces.size(), UNVISITED)
+        , failures(inFontFaces.size())
+    { }
+
+    /**
+     * @brief Checks whether the character can be rendered.
+    */
+    bool check(uint32_t character) {
+        if(states[character] == RENDERABLE || states[character] == BROKEN) {
+            return states[character] == RENDERABLE;
+        }
+        if(inFontFaces[character]) {
+            states[character] = RENDERABLE;
+            return true;
+        }
+        if(firstRecipeComponents[character].empty()) {
+            states[character] = BROKEN;
+            failures[character] = {crafting::CharacterId(character), crafting::CharacterId(character), false};
+            return false;
+        }
+        states[character] = VISITING;
+        for(uint32_t component : firstRecipeComponents[character]) {
+            if(states[component] == VISITING) {
+                states[character] = BROKEN;
+                failures[character] = {crafting::CharacterId(character), crafting::CharacterId(component), true};
+                return false;
+            }
+            if(!check(component)) {
+                states[character] = BROKEN;
+                failures[character] = {crafting::CharacterId(character), failures[component].component, failures[component].cycle};
+                return false;
+            }
+        }
+        states[character] = RENDERABLE;
+        return true;
+    }
+
+    const DatabaseReport::BrokenRender& getFailure(uint32_t character) const { return failures[character]; }
+};
+
+DatabaseReport validateDatabase(const std::vector<std::string>& idsPaths, unsigned int threads) {
+    DatabaseReport report;
+    for(const std::string& path : idsPaths) {
+        std::vector<RecipeError> errors = findRecipeErrors(path, threads);
+        report.recipeErrors.insert(report.recipeErrors.end(), errors.begin(), errors.end());
+    }
+
+    size_t numCharacters = crafting::characterTable.size() + 1;
+    std::vector<std::vector<uint32_t>> components(numCharacters);
+    std::vector<std::vector<uint32_t>> firstRecipeComponents(numCharacters);
+    std::vector<std::vector<DatabaseReport::DuplicateRecipe>> duplicates(numCharacters);
+    util::parallelFor(numCharacters - 1, [&](size_t index, unsigned int) {
+        uint32_t id = index + 1;
+        const crafting::Character& character = crafting::characterTable[crafting::CharacterId(id)];
+        const std::vector<crafting::Recipe>& recipes = character.getRecipes();
+        // the recipe the character is rendered with in the default region
+        const crafting::Recipe* renderedRecipe = character.getActiveRecipe(crafting::getDefaultRegion());
+        for(size_t i = 0; i < recipes.size(); i++) {
+            collectLeaves(recipes[i], &recipes[i] == renderedRecipe ? firstRecipeComponents[id] : components[id]);
+            for(size_t j = 0; j < i; j++) {
+                if(recipes[i] == recipes[j]) {
+                    duplicates[id].push_back({crafting::CharacterId(id), uint32_t(i), uint32_t(j)});
+                    break;
+                }
+            }
+        }
+        components[id].insert(components[id].end(), firstRecipeComponents[id].begin(), firstRecipeComponents[id].end());
+        std::sort(components[id].begin(), components[id].end());
+        components[id].erase(std::unique(components[id].begin(), components[id].end()), components[id].end());
+    }, threads);
+    for(const auto& characterDuplicates : duplicates) {
+        report.duplicateRecipes.insert(report.duplicateRecipes.end(), characterDuplicates.begin(), characterDuplicates.end());
+    }
+
+    report.cycles = findCycles(components);
+
+    // the font faces are looked up on this thread, since FreeType font faces are not thread-safe
+    std::vector<bool> inFontFaces(numCharacters, false);
+    for(uint32_t id = 1; id < numCharacters; id++) {
+        inFontFaces[id] = crafting::characterTable[crafting::CharacterId(id)].isInFontFaces();
+    }
+    RenderChecker renderChecker(inFontFaces, firstRecipeComponents);
+    for(uint32_t id = 1; id < numCharacters; id++) {
+        if(renderChecker.check(id)) {
+            continue;
+        }
+        if(firstRecipeComponents[id].empty()) {
+            report.unrenderable.push_back(crafting::CharacterId(id));
+        }
+        else {
+            report.brokenRenders.push_back(renderChecker.getFailure(id));
+        }
+    }
+
+    for(uint32_t i = 0; i < crafting::componentIndex.size(); i++) {
+        if(crafting::componentIndex.getResults(i).size() > 1) {
+            report.sharedRecipes.push_back(i);
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal.
+*/
+static void writeJsonString(std::ostream& out, const std::string& string) {
+    out << '"';
+    for(char c : string) {
+        switch(c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if((unsigned char)c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                }
+                else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+static void writeJsonCharacter(std::ostream& out, crafting::CharacterId character) {
+    writeJsonString(out, util::u32_to_u8(std::u32string(1, crafting::characterTable[character].getCharacter())));
+}
+
+/**
+ * @brief Writes a JSON array, with writeElement(element) writing each element.
+*/
+template<typename T, typename Function>
+static void writeJsonArray(std::ostream& out, const std::vector<T>& elements, Function writeElement) {
+    out << '[';
+    for(size_t i = 0; i < elements.size(); i++) {
+        out << (i == 0 ? "\n    " : ",\n    ");
+        writeElement(elements[i]);
+    }
+    out << (elements.empty() ? "]" : "\n  ]");
+}
+
+void DatabaseReport::writeJson(std::ostream& out) const {
+    out << "{\n  \"summary\": {"
+        << "\"recipeErrors\": " << recipeErrors.size()
+        << ", \"cycles\": " << cycles.size()
+        << ", \"unrenderable\": " << unrenderable.size()
+        << ", \"brokenRenders\": " << brokenRenders.size()
+        << ", \"duplicateRecipes\": " << duplicateRecipes.size()
+        << ", \"sharedRecipes\": " << sharedRecipes.size() << "},\n";
+
+    out << "  \"recipeErrors\": ";
+    writeJsonArray(out, recipeErrors, [&](const RecipeError& error) {
+        out << "{\"file\": ";
+        writeJsonString(out, error.path);
+        out << ", \"line\": " << error.lineNum << ", \"character\": ";
+        writeJsonString(out, error.character ? util::u32_to_u8(std::u32string(1, error.character)) : "");
+        out << ", \"recipe\": ";
+        writeJsonString(out, util::u32_to_u8(error.recipe));
+        out << ", \"message\": ";
+        writeJsonString(out, error.message);
+        out << '}';
+    });
+
+    out << ",\n  \"cycles\": ";
+    writeJsonArray(out, cycles, [&](const std::vector<crafting::CharacterId>& cycle) {
+        out << '[';
+        for(size_t i = 0; i < cycle.size(); i++) {
+            out << (i == 0 ? "" : ", ");
+            writeJsonCharacter(out, cycle[i]);
+        }
+        out << ']';
+    });
+
+    out << ",\n  \"unrenderable\": ";
+    writeJsonArray(out, unrenderable, [&](crafting::CharacterId character) {
+        writeJsonCharacter(out, character);
+    });
+
+    out << ",\n  \"brokenRenders\": ";
+    writeJsonArray(out, brokenRenders, [&](const BrokenRender& broken) {
+        out << "{\"character\": ";
+        writeJsonCharacter(out, broken.character);
+        out << ", \"component\": ";
+        writeJsonCharacter(out, broken.component);
+        out << ", \"reason\": " << (broken.cycle ? "\"cycle\"" : "\"unrenderable\"") << '}';
+    });
+
+    out << ",\n  \"duplicateRecipes\": ";
+    writeJsonArray(out, duplicateRecipes, [&](const DuplicateRecipe& duplicate) {
+        out << "{\"character\": ";
+        writeJsonCharacter(out, duplicate.character);
+        out << ", \"recipe\": ";
+        writeJsonString(out, util::u32_to_u8(crafting::characterTable[duplicate.character].getRecipes()[duplicate.recipe]));
+        out << ", \"index\": " << duplicate.recipe << ", \"duplicateOf\": " << duplicate.duplicateOf << '}';
+    });
+
+    out << ",\n  \"sharedRecipes\": ";
+    writeJsonArray(out, sharedRecipes, [&](uint32_t recipe) {
+        out << "{\"recipe\": ";
+        writeJsonString(out, util::u32_to_u8(crafting::componentIndex.getRecipe(recipe)));
+        out << ", \"characters\": [";
+        const std::vector<crafting::CharacterId>& results = crafting::componentIndex.getResults(recipe);
+        for(size_t i = 0; i < results.size(); i++) {
+            out << (i == 0 ? "" : ", ");
+            writeJsonCharacter(out, results[i]);
+        }
+        out << "]}";
+    });
+    out << "\n}\n";
+}
+
+} // namespace loading
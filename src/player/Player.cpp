@@ -8,6 +8,7 @@ Player::Player(unsigned int maxHealth, unsigned int maxInk, unsigned int health,
     , mGold(gold)
     , mInk(ink)
     , inventory()
+    , region(crafting::getDefaultRegion())
     , modifiers{
         { "Base", Stats::MAX_HEALTH, (int)maxHealth },
         { "Base", Stats::MAX_INK, (int)maxInk }
@@ -84,21 +85,22 @@ bool Player::removeModifier(Modifier* modifierPtr) {
 }
 
 bool Player::craft(const crafting::Recipe& recipe, unsigned int variation) {
-    auto it = crafting::recipeMap.find(recipe);
-    if(it == crafting::recipeMap.end()) {
-        return false;
-    }
-    std::vector<std::shared_ptr<crafting::Character>> results = it->second;
-    if(variation >= results.size()) {
+    const crafting::Recipe* found;
+    const std::vector<crafting::CharacterId>* results = crafting::findRecipeResults(recipe, &found);
+    if(!results || variation >= results->size() || !crafting::isRecipeActive(*found, (*results)[variation], region)) {
         return false;
     }
     if(!inventory.removeIngredients(recipe)) {
         return false;
     }
-    inventory.addItem(results[variation]->getCharacter());
+    inventory.addItem((*results)[variation]);
     return true;
 }
 
+bool Player::planCraft(crafting::CharacterId target, std::vector<crafting::CraftStep>& steps) {
+    return planner.plan(inventory, region, target, steps);
+}
+
 
 
 } // namespace player
\ No newline at end of file
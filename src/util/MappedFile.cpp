@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+#include <utility>
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace util {
+
+// Empty files can not be mapped, so they are represented by a pointer to this instead.
+static const char emptyFile[1] = {0};
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+        close();
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+        #ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+        #endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    if(fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        mData = emptyFile;
+        mSize = 0;
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if(mData != nullptr && mData != emptyFile) {
+        UnmapViewOfFile(mData);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+    mData = nullptr;
+    mSize = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if(fileStat.st_size == 0) {
+        ::close(fd);
+        mData = emptyFile;
+        mSize = 0;
+        return true;
+    }
+    void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid after the descriptor is closed
+    if(mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+    mData = static_cast<const char*>(mapping);
+    mSize = static_cast<size_t>(fileStat.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if(mData != nullptr && mData != emptyFile) {
+        munmap(const_cast<char*>(mData), mSize);
+    }
+    mData = nullptr;
+    mSize = 0;
+}
+
+#endif
+
+} // namespace util
@@ -0,0 +1,82 @@
+#include "StringPool.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace util {
+
+// The index is grown when more than half of its slots are used.
+static constexpr size_t MIN_INDEX_SIZE = 1024;
+
+StringPool::Location StringPool::store(std::string_view string) {
+    if(string.size() > blockSize) {
+        largeStrings.push_back(std::make_unique<char[]>(string.size()));
+        std::memcpy(largeStrings.back().get(), string.data(), string.size());
+        return {uint32_t(largeStrings.size() - 1) | LARGE_BIT, uint32_t(string.size())};
+    }
+    if(blocks.empty() || blockSize - used < string.size()) {
+        if((blocks.size() + 1) * blockSize > LARGE_BIT) {
+            throw std::length_error("String pool is full.");
+        }
+        blocks.push_back(std::make_unique<char[]>(blockSize));
+        used = 0;
+    }
+    uint32_t start = (blocks.size() - 1) * blockSize + used;
+    if(!string.empty()) {
+        std::memcpy(blocks.back().get() + used, string.data(), string.size());
+    }
+    used += string.size();
+    return {start, uint32_t(string.size())};
+}
+
+uint32_t& StringPool::findSlot(std::string_view string) {
+    size_t mask = index.size() - 1;
+    for(size_t slot = std::hash<std::string_view>()(string) & mask; ; slot = (slot + 1) & mask) {
+        if(index[slot] == 0 || (*this)[index[slot] - 1] == string) {
+            return index[slot];
+        }
+    }
+}
+
+void StringPool::rehash(size_t numSlots) {
+    index.assign(numSlots, 0);
+    for(uint32_t id = 0; id < locations.size(); id++) {
+        findSlot((*this)[id]) = id + 1;
+    }
+}
+
+uint32_t StringPool::intern(std::string_view string) {
+    if((locations.size() + 1) * 2 > index.size()) {
+        size_t numSlots = std::max(index.size(), MIN_INDEX_SIZE);
+        while((locations.size() + 1) * 2 > numSlots) {
+            numSlots *= 2;
+        }
+        rehash(numSlots);
+    }
+    uint32_t& slot = findSlot(string);
+    if(slot != 0) {
+        return slot - 1;
+    }
+    locations.push_back(store(string));
+    numBytes += string.size();
+    slot = locations.size();
+    return slot - 1;
+}
+
+void StringPool::freeze() {
+    index.clear();
+    index.shrink_to_fit();
+    locations.shrink_to_fit();
+}
+
+void StringPool::clear() {
+    blocks.clear();
+    largeStrings.clear();
+    used = blockSize;
+    locations.clear();
+    index.clear();
+    numBytes = 0;
+}
+
+} // namespace util
@@ -11,4 +11,12 @@ void setBit(uint8_t* byte, int idx, bool value) {
     }
 }
 
+uint64_t fnv1a(std::string_view bytes, uint64_t hash) {
+    for(char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 } // namespace util
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "parallelUtil.h"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+unsigned int threadCount(unsigned int requested) {
+    if(requested != 0) {
+        return requested;
+    }
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads != 0 ? hardwareThreads : 1;
+}
+
+void parallelFor(size_t count, const std::function<void(size_t index, unsigned int worker)>& task, unsigned int threads) {
+    threads = threadCount(threads);
+    if(threads > count) {
+        threads = count;
+    }
+    if(threads <= 1) {
+        for(size_t i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    std::atomic<size_t> nextIndex{0};
+    std::exception_ptr firstException;
+    std::mutex exceptionMutex;
+    auto work = [&](unsigned int worker) {
+        for(size_t i = nextIndex++; i < count; i = nextIndex++) {
+            try {
+                task(i, worker);
+            }
+            catch(...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if(!firstException) {
+                    firstException = std::current_exception();
+                }
+                nextIndex = count;
+                return;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for(unsigned int worker = 1; worker < threads; worker++) {
+        pool.emplace_back(work, worker);
+    }
+    work(0); // the calling thread works as well
+    for(std::thread& thread : pool) {
+        thread.join();
+    }
+    if(firstException) {
+        std::rethrow_exception(firstException);
+    }
+}
+
+} // namespace util
@@ -13,6 +13,55 @@ std::u32string u8_to_u32(const std::string& str)  {
     return convert.from_bytes(str);
 }
 
+char32_t decodeUtf8(std::string_view str, size_t& pos) {
+    unsigned char lead = str[pos++];
+    if(lead < 0x80) {
+        return lead;
+    }
+    int numContinuation;
+    char32_t result;
+    if((lead & 0xE0) == 0xC0) {
+        numContinuation = 1;
+        result = lead & 0x1F;
+    }
+    else if((lead & 0xF0) == 0xE0) {
+        numContinuation = 2;
+        result = lead & 0x0F;
+    }
+    else if((lead & 0xF8) == 0xF0) {
+        numContinuation = 3;
+        result = lead & 0x07;
+    }
+    else {
+        return U'\uFFFD';
+    }
+    for(int i = 0; i < numContinuation; i++) {
+        if(pos >= str.size() || (static_cast<unsigned char>(str[pos]) & 0xC0) != 0x80) {
+            return U'\uFFFD';
+        }
+        result = (result << 6) | (static_cast<unsigned char>(str[pos++]) & 0x3F);
+    }
+    return result;
+}
+
+void u8_to_u32(std::string_view str, std::u32string& out) {
+    out.clear();
+    size_t pos = 0;
+    while(pos < str.size()) {
+        out += decodeUtf8(str, pos);
+    }
+}
+
+size_t u8_length(std::string_view str) {
+    size_t length = 0;
+    for(char c : str) {
+        if((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            length++;
+        }
+    }
+    return length;
+}
+
 char32_t unicodeToChar(const std::string& unicode) {
     return std::stoi(unicode.substr(2), nullptr, 16);
 }
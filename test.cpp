@@ -16,27 +16,28 @@ int main() {
     loading::loadMeanings();
     loading::loadFreeType();
 
-    // for(auto& c : characterMap) {
-    //     if(c.second->canBePlacedLike(U'⿺')) {
-    //         std::cout << util::u32_to_u8(std::u32string(1, c.second->getCharacter())) << "\n";
+    // for(auto& c : characterTable) {
+    //     if(c.canBePlacedLike(U'⿺')) {
+    //         std::cout << util::u32_to_u8(std::u32string(1, c.getCharacter())) << "\n";
     //     }
     // }
 
-    std::shared_ptr<Ingredient> r = std::make_shared<EmptyIngredient>();
-    r = r->addLeft(getCharacter(U'乸'));
+    EmptyIngredient empty;
+    const Ingredient* r = &empty;
+    r = r->addLeft(getCharacterId(U'乸'));
     std::cout << "first" << std::endl;
-    r = r->addLeft(getCharacter(U'木'));
+    r = r->addLeft(getCharacterId(U'木'));
     std::cout << "second" << std::endl;
-    r = r->addAbove(getCharacter(U'𠆢'));
+    r = r->addAbove(getCharacterId(U'𠆢'));
     std::cout << "third" << std::endl;
-    r->render(200,200).printToFile("test.bmp");
+    r->render(200,200,getDefaultRegion()).printToFile("test.bmp");
     std::cout << "fourth" << std::endl;
 
 
 
     //
-    //getCharacter(U'乸')->getRecipes()[0].render(200,200).printToFile("test.bmp");
-    //getCharacter(U'')->render(200, 200).printToFile("test.bmp");
+    //getCharacter(U'乸').getRecipes()[0].render(200,200).printToFile("test.bmp");
+    //getCharacter(U'').render(200, 200).printToFile("test.bmp");
 
     /*FT_Set_Pixel_Sizes(rendering::fontFace, 200, 200);
     FT_Error error = FT_Load_Char(rendering::fontFace, U'𠆢', FT_LOAD_RENDER);
@@ -48,13 +49,13 @@ int main() {
     
     rendering::Bitmap(bitmap).printToFile("test.bmp");*/
 
-    /*getCharacter(U'木')->addFunctionality(std::make_unique<items::HealthConsumable>(10));
-    std::cout << "Functionality of 木: " << getCharacter(U'木')->getFunctionalities()[0]->getDescription() << std::endl;
+    /*getCharacter(U'木').addFunctionality(std::make_unique<items::HealthConsumable>(10));
+    std::cout << "Functionality of 木: " << getCharacter(U'木').getFunctionalities()[0]->getDescription() << std::endl;
 
-    std::cout << "Recipe for 木: " << util::u32_to_u8(getCharacter(U'木')->getRecipes()[0]) << std::endl;
-    std::cout << "Result of ⿻𠆢十: " << util::u32_to_u8(*recipeMap[Recipe(U"⿻十𠆢")][0]) << std:: endl;
+    std::cout << "Recipe for 木: " << util::u32_to_u8(getCharacter(U'木').getRecipes()[0]) << std::endl;
+    std::cout << "Result of ⿻𠆢十: " << util::u32_to_u8(characterTable[recipeMap[Recipe(U"⿻十𠆢")][0]]) << std:: endl;
     std::cout << "Meanings of 木: ";
-    for(auto& meaning : getCharacter(U'木')->getMeanings()) {
+    for(auto& meaning : getCharacter(U'木').getMeanings()) {
         std::cout << meaning << ", ";
     }
     std::cout << std::endl;
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include "loading.h"
+#include "DatabaseReport.h"
+#include "hashMaps.h"
+
+/**
+ * Checks the whole database and writes the problems found to a JSON report.
+ * Also prints how well the recipe map is distributed.
+ * Usage: validate [report path] [threads]
+ * Exits with 1 if problems were found, so it can be run before a release.
+*/
+int main(int argc, char** argv) {
+    std::string reportPath = argc > 1 ? argv[1] : "validation_report.json";
+    unsigned int threads = argc > 2 ? std::stoul(argv[2]) : 0;
+
+    loading::loadAll();
+    auto start = std::chrono::steady_clock::now();
+    loading::DatabaseReport report = loading::validateDatabase({"resources/ids/IDS_content_only.TXT", "resources/ids/IDS_PUA.TXT"}, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file(reportPath);
+    if(!file) {
+        std::cerr << "Could not open " << reportPath << std::endl;
+        return 2;
+    }
+    report.writeJson(file);
+    std::cout << "Found " << report.numProblems() << " problems in " << seconds * 1000 << " ms: "
+        << report.recipeErrors.size() << " recipe errors, "
+        << report.cycles.size() << " cycles, "
+        << report.unrenderable.size() << " unrenderable characters, "
+        << report.brokenRenders.size() << " broken renders, "
+        << report.duplicateRecipes.size() << " duplicate recipes. "
+        << report.sharedRecipes.size() << " recipes make several characters. "
+        << "Report written to " << reportPath << std::endl;
+    crafting::printRecipeMapReport(std::cout);
+    return report.numProblems() > 0 ? 1 : 0;
+}